@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#define POLYNOMIAL_NOINLINE __declspec(noinline)
+#else
+#define POLYNOMIAL_NOINLINE __attribute__((noinline))
+#endif
+
+
+// Replacements of the global operator new and delete that count allocations,
+// for the tests and benchmarks that check how often the polynomial code goes
+// to the heap. Include it in exactly one translation unit. Every replaced form
+// goes through the two functions below; they are kept out of line so that the
+// compiler does not see malloc and free meet the new and delete expressions.
+static std::atomic<size_t> allocations(0);
+static std::atomic<size_t> allocated_bytes(0);
+
+POLYNOMIAL_NOINLINE void* CountedAllocate(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+POLYNOMIAL_NOINLINE void CountedFree(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void* operator new(size_t size) {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size) {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    CountedFree(pointer);
+}
+
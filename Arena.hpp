@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#include "Stats.hpp"
+
+
+// Memory resource that hands out consecutive pieces of one block reserved up
+// front and frees nothing until it is released or destroyed. When the block
+// runs out it continues in blocks taken from operator new.
+class PolynomialArena : public std::pmr::memory_resource {
+private:
+    std::unique_ptr<unsigned char[]> block;
+    std::pmr::monotonic_buffer_resource resource;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return resource.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit PolynomialArena(size_t bytes)
+        : block(new unsigned char[bytes]), resource(block.get(), bytes, std::pmr::new_delete_resource()) {}
+
+    PolynomialArena(const PolynomialArena&) = delete;
+    PolynomialArena& operator =(const PolynomialArena&) = delete;
+
+    // Makes the whole block available again; nothing allocated from the arena
+    // may be used afterwards.
+    void Release() {
+        resource.release();
+    }
+};
+
+// While an ArenaScope is alive, every polynomial and every temporary buffer
+// created on this thread takes its memory from the given resource. Scopes
+// nest; the destructor restores the previous one. Objects created inside a
+// scope must not outlive the resource, while objects created outside keep
+// their memory even when they are assigned to inside. Other threads, such as
+// the workers of the shared ThreadPool, are not affected.
+class ArenaScope {
+private:
+    std::pmr::memory_resource* previous;
+
+    static inline thread_local std::pmr::memory_resource* current = 0;
+
+public:
+    explicit ArenaScope(std::pmr::memory_resource& resource) : previous(current) {
+        current = &resource;
+    }
+
+    ~ArenaScope() {
+        current = previous;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator =(const ArenaScope&) = delete;
+
+    static std::pmr::memory_resource* Current() {
+        return current;
+    }
+};
+
+// Allocator bound to the resource of the ArenaScope active when it was created,
+// or to operator new when there is none. Copies of a container rebind to the
+// scope active at the time of the copy; move assignment between containers of
+// different resources copies the elements instead of taking the memory.
+template<class T>
+class ArenaAllocator {
+private:
+    std::pmr::memory_resource* resource;
+
+    template<class U>
+    friend class ArenaAllocator;
+
+public:
+    typedef T value_type;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator() : resource(ArenaScope::Current()) {}
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : resource(other.resource) {}
+
+    T* allocate(size_t count) {
+        CountStat(StatCounter::Allocations);
+        CountStat(StatCounter::AllocatedBytes, count * sizeof(T));
+        if (resource) {
+            return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+        }
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (resource) {
+            resource->deallocate(pointer, count * sizeof(T), alignof(T));
+        } else {
+            std::allocator<T>().deallocate(pointer, count);
+        }
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    template<class U>
+    bool operator ==(const ArenaAllocator<U>& other) const {
+        return resource == other.resource;
+    }
+
+    template<class U>
+    bool operator !=(const ArenaAllocator<U>& other) const {
+        return resource != other.resource;
+    }
+};
+
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
@@ -0,0 +1,442 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "Polynomial.h"
+#include "ModInt.h"
+#include "PolynomialBatch.h"
+#include "Roots.h"
+#include "BigInt.h"
+#include "CachedPolynomial.h"
+#include "AllocationCounter.hpp"
+
+// Build with
+//     g++ -std=c++17 -O2 -I. Benchmarks.cpp -lbenchmark -pthread -o benchmarks
+// and record a run with
+//     ./benchmarks --benchmark_out=results.json --benchmark_out_format=json
+// Two such files can be compared with tools/compare.py from Google Benchmark.
+
+
+typedef ModInt<998244353> Residue;
+
+// Adds allocs/op and bytes/op counters for the allocations made between its
+// construction and the end of the benchmark; create it right before the loop.
+class AllocationReport {
+private:
+    benchmark::State& state;
+    size_t allocations_before;
+    size_t bytes_before;
+
+public:
+    explicit AllocationReport(benchmark::State& state)
+        : state(state), allocations_before(allocations), bytes_before(allocated_bytes) {}
+
+    ~AllocationReport() {
+        state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocations - allocations_before),
+                                                         benchmark::Counter::kAvgIterations);
+        state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(allocated_bytes - bytes_before),
+                                                        benchmark::Counter::kAvgIterations);
+    }
+};
+
+
+template<class T>
+Polynomial<T> random_polynom(int degree, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    vector<T> seq;
+    for (int i = 0; i < degree + 1; ++i) {
+        seq.push_back(T(distribution(generator)));
+    }
+    seq[0] = T(100);
+    return Polynomial<T>(seq.begin(), seq.end());
+}
+
+// The second argument selects the kernels: 0 is the scalar fallback,
+// 1 is the widest instruction set detected on this machine.
+struct SimdLevelScope {
+    SimdLevel saved;
+
+    explicit SimdLevelScope(benchmark::State& state) : saved(SimdSettings::level) {
+        SimdSettings::level = state.range(1) ? DetectSimdLevel() : SimdLevel::Scalar;
+    }
+
+    ~SimdLevelScope() {
+        SimdSettings::level = saved;
+    }
+};
+
+// Every iteration adds and then subtracts, so integer coefficients stay
+// bounded however long the benchmark runs.
+template<class T>
+void BM_AddSubtract(benchmark::State& state) {
+    SimdLevelScope scope(state);
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    for (auto _ : state) {
+        lhs += rhs;
+        lhs -= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetItemsProcessed(2 * state.iterations() * state.range(0));
+}
+
+template<class T>
+void BM_Scale(benchmark::State& state) {
+    SimdLevelScope scope(state);
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    for (auto _ : state) {
+        polynom *= T(-1);
+        benchmark::DoNotOptimize(polynom);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class T>
+void BM_Axpy(benchmark::State& state) {
+    SimdLevelScope scope(state);
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    for (auto _ : state) {
+        lhs += T(3) * rhs;
+        lhs -= T(3) * rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetItemsProcessed(2 * state.iterations() * state.range(0));
+}
+
+template<class T>
+void BM_Horner(benchmark::State& state) {
+    SimdLevelScope scope(state);
+    Polynomial<T> polynom = random_polynom<T>(64, 1);
+    vector<T> points(state.range(0));
+    for (size_t index = 0; index < points.size(); ++index) {
+        points[index] = T(index % 3) - T(1);
+    }
+    vector<T> values(points.size());
+    for (auto _ : state) {
+        polynom.Evaluate(&points[0], points.size(), &values[0]);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The second argument selects Execution::Sequential (0) or Execution::Parallel (1).
+template<class T>
+void BM_Multiply(benchmark::State& state) {
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    Execution execution = state.range(1) ? Execution::Parallel : Execution::Sequential;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Multiply(lhs, rhs, execution));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Big integer products with coefficients of range(1) decimal digits; the third
+// argument forces Karatsuba (0) or the multi-modular product (1).
+void BM_BigIntMultiply(benchmark::State& state) {
+    std::mt19937 generator(1);
+    vector<BigInt> lhs_seq, rhs_seq;
+    for (int index = 0; index < state.range(0); ++index) {
+        for (vector<BigInt>* seq : {&lhs_seq, &rhs_seq}) {
+            std::string text = generator() % 2 ? "-1" : "1";
+            for (int digit = 1; digit < state.range(1); ++digit) {
+                text.push_back(static_cast<char>('0' + generator() % 10));
+            }
+            seq->push_back(BigInt(text));
+        }
+    }
+    Polynomial<BigInt> lhs(lhs_seq.begin(), lhs_seq.end());
+    Polynomial<BigInt> rhs(rhs_seq.begin(), rhs_seq.end());
+    size_t saved = MultiplicationThresholds::multi_modular;
+    MultiplicationThresholds::multi_modular = state.range(2) ? 0 : lhs_seq.size() + 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs * rhs);
+    }
+    MultiplicationThresholds::multi_modular = saved;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// One coefficient write followed by the values at 16 points: Horner at every
+// point (0) against the delta updates of CachedPolynomial (1).
+template<class T>
+void BM_CachedEvaluate(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    vector<T> points(16);
+    for (size_t index = 0; index < points.size(); ++index) {
+        points[index] = T(1) / T(index + 2);
+    }
+    CachedPolynomial<T> cached(polynom, points);
+    size_t index = 0;
+    for (auto _ : state) {
+        index = (index + 7) % polynom.Degree();
+        if (state.range(1)) {
+            cached[index] += T(1);
+            benchmark::DoNotOptimize(cached.Values());
+        } else {
+            polynom[index] += T(1);
+            benchmark::DoNotOptimize(polynom.Evaluate(points));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+template<class T>
+void BM_ParallelEvaluate(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(256, 1);
+    vector<T> points(state.range(0));
+    for (size_t index = 0; index < points.size(); ++index) {
+        points[index] = T(index % 3) - T(1);
+    }
+    vector<T> values(points.size());
+    Execution execution = state.range(1) ? Execution::Parallel : Execution::Sequential;
+    for (auto _ : state) {
+        polynom.Evaluate(&points[0], points.size(), &values[0], execution);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The second argument forces the quadratic Lagrange method (0) or the subproduct
+// tree (1); the degree where the curves cross is InterpolationThresholds.
+template<class T>
+void BM_Interpolate(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0) - 1, 1);
+    vector<T> points(state.range(0));
+    for (size_t index = 0; index < points.size(); ++index) {
+        points[index] = T(static_cast<int>(index));
+    }
+    vector<T> values = polynom.Evaluate(points);
+    size_t saved = InterpolationThresholds::subproduct_tree;
+    InterpolationThresholds::subproduct_tree = state.range(1) ? 0 : points.size() + 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Interpolate(points, values));
+    }
+    InterpolationThresholds::subproduct_tree = saved;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class T>
+void BM_ComplexRoots(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ComplexRoots(polynom));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Exact isolation of built-in integers in BigInt arithmetic; the sweep stops at
+// degree 1000, where one isolation already takes seconds. The second argument
+// refines the intervals on the ThreadPool (1) or not (0).
+template<class T>
+void BM_RealRoots(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    Execution execution = state.range(1) ? Execution::Parallel : Execution::Sequential;
+    size_t parallel_refine = RootThresholds::parallel_refine;
+    RootThresholds::parallel_refine = 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(RealRoots(polynom, execution));
+    }
+    RootThresholds::parallel_refine = parallel_refine;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Products and values of many degree 4 polynomials, stored separately (0) or
+// in one PolynomialBatch (1).
+template<class T>
+void BM_ManySmall(benchmark::State& state) {
+    vector<Polynomial<T> > lhs, rhs;
+    for (int index = 0; index < state.range(0); ++index) {
+        lhs.push_back(random_polynom<T>(4, 2 * index));
+        rhs.push_back(random_polynom<T>(4, 2 * index + 1));
+    }
+    vector<T> points(state.range(0), T(1));
+    vector<T> values(state.range(0));
+    if (state.range(1)) {
+        PolynomialBatch<T> lhs_batch(lhs), rhs_batch(rhs);
+        for (auto _ : state) {
+            PolynomialBatch<T> product = lhs_batch * rhs_batch;
+            product.Evaluate(&points[0], &values[0]);
+            benchmark::DoNotOptimize(values.data());
+        }
+    } else {
+        for (auto _ : state) {
+            for (size_t index = 0; index < lhs.size(); ++index) {
+                values[index] = (lhs[index] * rhs[index])(points[index]);
+            }
+            benchmark::DoNotOptimize(values.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// One benchmark per Polynomial operation, each run for every coefficient type
+// over degrees 1 to 10^6. Operations that are quadratic for some types stop
+// at smaller degrees.
+template<class T>
+void BM_AddAssign(benchmark::State& state) {
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        lhs += rhs;
+        lhs -= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetItemsProcessed(2 * state.iterations());
+}
+
+template<class T>
+void BM_MultiplyAssign(benchmark::State& state) {
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        Polynomial<T> product(lhs);
+        product *= rhs;
+        benchmark::DoNotOptimize(product);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The divisor is monic, so integer division runs to the end instead of
+// stopping at the first leading coefficient it cannot divide.
+template<class T>
+Polynomial<T> monic_polynom(int degree, unsigned seed) {
+    Polynomial<T> polynom = random_polynom<T>(degree, seed);
+    polynom[degree] = T(1);
+    return polynom;
+}
+
+template<class T>
+void BM_Divide(benchmark::State& state) {
+    Polynomial<T> dividend = random_polynom<T>(2 * state.range(0), 1);
+    Polynomial<T> divisor = monic_polynom<T>(state.range(0), 2);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dividend / divisor);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+void BM_Modulo(benchmark::State& state) {
+    Polynomial<T> dividend = random_polynom<T>(2 * state.range(0), 1);
+    Polynomial<T> divisor = monic_polynom<T>(state.range(0), 2);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dividend % divisor);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+void BM_Gcd(benchmark::State& state) {
+    Polynomial<T> lhs = monic_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = monic_polynom<T>(state.range(0) / 2 + 1, 2);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((lhs, rhs));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+void BM_Value(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    T point = T(-1);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polynom(point));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+void BM_Shift(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        Polynomial<T> shifted(polynom);
+        shifted.Shift(16);
+        benchmark::DoNotOptimize(shifted);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class T>
+void BM_Print(benchmark::State& state) {
+    Polynomial<T> polynom = random_polynom<T>(state.range(0), 1);
+    AllocationReport report(state);
+    for (auto _ : state) {
+        std::ostringstream stream;
+        stream << polynom;
+        benchmark::DoNotOptimize(stream);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define POLYNOMIAL_TYPE_BENCHMARK(Name, IntegerLimit, FieldLimit)                                    \
+    BENCHMARK_TEMPLATE(Name, int)->RangeMultiplier(10)->Range(1, IntegerLimit);                       \
+    BENCHMARK_TEMPLATE(Name, long long)->RangeMultiplier(10)->Range(1, IntegerLimit);                 \
+    BENCHMARK_TEMPLATE(Name, double)->RangeMultiplier(10)->Range(1, FieldLimit);                      \
+    BENCHMARK_TEMPLATE(Name, Residue)->RangeMultiplier(10)->Range(1, FieldLimit)
+
+POLYNOMIAL_TYPE_BENCHMARK(BM_AddAssign, 1000000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_MultiplyAssign, 1000000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Divide, 100000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Modulo, 100000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Gcd, 10000, 100000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Value, 1000000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Shift, 1000000, 1000000);
+POLYNOMIAL_TYPE_BENCHMARK(BM_Print, 1000000, 1000000);
+
+// Construction, copy and addition of polynomials small enough for the inline
+// coefficient buffer; the allocation counter stays at zero.
+template<class T>
+void BM_SmallPolynomial(benchmark::State& state) {
+    Polynomial<T> lhs = random_polynom<T>(state.range(0), 1);
+    Polynomial<T> rhs = random_polynom<T>(state.range(0), 2);
+    for (auto _ : state) {
+        Polynomial<T> constant(T(3));
+        Polynomial<T> copy(lhs);
+        copy += rhs;
+        copy -= constant;
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_SmallPolynomial, double)->DenseRange(0, 8, 4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_SmallPolynomial, int)->DenseRange(0, 8, 4)->Arg(16)->Arg(64);
+
+BENCHMARK_TEMPLATE(BM_Multiply, int)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 4), {0, 1}});
+BENCHMARK_TEMPLATE(BM_Multiply, double)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 4), {0, 1}});
+BENCHMARK(BM_BigIntMultiply)->ArgsProduct({{4, 8, 16, 32, 128, 512}, {20, 200}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Interpolate, Residue)->ArgsProduct({benchmark::CreateRange(64, 1 << 14, 2), {0, 1}});
+BENCHMARK_TEMPLATE(BM_ComplexRoots, double)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK_TEMPLATE(BM_RealRoots, long long)->ArgsProduct({benchmark::CreateRange(10, 1000, 10), {0, 1}});
+BENCHMARK_TEMPLATE(BM_ManySmall, double)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 16, 8), {0, 1}});
+BENCHMARK_TEMPLATE(BM_ManySmall, int)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 16, 8), {0, 1}});
+BENCHMARK_TEMPLATE(BM_CachedEvaluate, double)->ArgsProduct({benchmark::CreateRange(16, 1 << 16, 16), {0, 1}});
+BENCHMARK_TEMPLATE(BM_ParallelEvaluate, double)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 8), {0, 1}});
+
+#define POLYNOMIAL_SIMD_BENCHMARK(Name)                                                             \
+    BENCHMARK_TEMPLATE(Name, double)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}}); \
+    BENCHMARK_TEMPLATE(Name, float)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}});  \
+    BENCHMARK_TEMPLATE(Name, int32_t)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}}); \
+    BENCHMARK_TEMPLATE(Name, int64_t)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}})
+
+POLYNOMIAL_SIMD_BENCHMARK(BM_AddSubtract);
+POLYNOMIAL_SIMD_BENCHMARK(BM_Scale);
+POLYNOMIAL_SIMD_BENCHMARK(BM_Axpy);
+POLYNOMIAL_SIMD_BENCHMARK(BM_Horner);
+
+BENCHMARK_MAIN();
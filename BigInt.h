@@ -0,0 +1,150 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "Arena.hpp"
+#include "CoefficientTraits.h"
+
+
+// Signed integer of any size: the magnitude in 32-bit limbs, least significant
+// first and without leading zero limbs, and a sign. Zero has no limbs and is
+// never negative. Division truncates towards zero like the built-in types, so
+// the remainder takes the sign of the dividend.
+class BigInt {
+private:
+    typedef std::vector<unsigned> Limbs;
+
+    Limbs limbs;
+    bool negative;
+
+    void Trim();
+
+    static int CompareMagnitude(const Limbs& lhs, const Limbs& rhs);
+    static void AddMagnitude(Limbs& lhs, const Limbs& rhs);
+    // Requires lhs >= rhs.
+    static void SubtractMagnitude(Limbs& lhs, const Limbs& rhs);
+    static Limbs MultiplyMagnitude(const Limbs& lhs, const Limbs& rhs);
+    static void DivideMagnitude(const Limbs& dividend, const Limbs& divisor, Limbs& quotient, Limbs& remainder);
+    static unsigned DivideSmall(Limbs& magnitude, unsigned divisor);
+
+    BigInt& AddSigned(const BigInt& other, bool subtract);
+
+public:
+    BigInt(long long value = 0);
+
+    // Decimal digits with an optional sign; throws std::invalid_argument.
+    explicit BigInt(std::string_view text);
+
+    bool IsZero() const;
+    bool IsNegative() const;
+
+    size_t BitLength() const;
+
+    // Value modulo a modulus below 2^32, in [0, modulus).
+    unsigned Modulo(unsigned modulus) const;
+
+    // *this = *this * factor + addend for non-negative values, in place.
+    BigInt& MultiplyAdd(unsigned factor, unsigned addend);
+
+    // Nearest double; infinite when out of range.
+    explicit operator double() const;
+
+    std::string ToString() const;
+
+    BigInt operator -() const;
+
+    BigInt& operator +=(const BigInt&);
+    BigInt& operator -=(const BigInt&);
+    BigInt& operator *=(const BigInt&);
+    BigInt& operator /=(const BigInt&);
+    BigInt& operator %=(const BigInt&);
+
+    friend BigInt operator +(BigInt lhs, const BigInt& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend BigInt operator -(BigInt lhs, const BigInt& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend BigInt operator *(const BigInt& lhs, const BigInt& rhs)
+    {
+        BigInt product;
+        product.limbs = MultiplyMagnitude(lhs.limbs, rhs.limbs);
+        product.negative = lhs.negative != rhs.negative;
+        product.Trim();
+        return product;
+    }
+
+    friend BigInt operator /(BigInt lhs, const BigInt& rhs)
+    {
+        return lhs /= rhs;
+    }
+
+    friend BigInt operator %(BigInt lhs, const BigInt& rhs)
+    {
+        return lhs %= rhs;
+    }
+
+    friend bool operator ==(const BigInt& lhs, const BigInt& rhs)
+    {
+        return lhs.negative == rhs.negative && lhs.limbs == rhs.limbs;
+    }
+
+    friend bool operator !=(const BigInt& lhs, const BigInt& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator <(const BigInt& lhs, const BigInt& rhs)
+    {
+        if (lhs.negative != rhs.negative) {
+            return lhs.negative;
+        }
+        int comparison = CompareMagnitude(lhs.limbs, rhs.limbs);
+        return lhs.negative ? comparison > 0 : comparison < 0;
+    }
+
+    friend bool operator >(const BigInt& lhs, const BigInt& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    friend bool operator <=(const BigInt& lhs, const BigInt& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator >=(const BigInt& lhs, const BigInt& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    friend std::ostream& operator <<(std::ostream& stream, const BigInt& value)
+    {
+        return stream << value.ToString();
+    }
+};
+
+// std::abs does not know BigInt, so monomials print the magnitude themselves.
+void AddMonomial(const BigInt& coef, int degree, std::ostream& stream, bool isFirst);
+
+// Long products and gcds go through images modulo word-sized primes, defined
+// in MultiModular.hpp.
+template<>
+struct CoefficientAlgorithms<BigInt> {
+    static const bool has_multiply = true;
+    static const bool has_gcd = true;
+
+    static bool Multiply(const BigInt* lhs, size_t lhs_size, const BigInt* rhs, size_t rhs_size, BigInt* out);
+
+    static ArenaVector<BigInt> Gcd(ArenaVector<BigInt> first, ArenaVector<BigInt> second);
+};
+
+#include "BigInt.hpp"
+#include "MultiModular.hpp"
@@ -0,0 +1,364 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+
+
+inline BigInt::BigInt(long long value) : negative(value < 0) {
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                             : static_cast<unsigned long long>(value);
+    while (magnitude > 0) {
+        limbs.push_back(static_cast<unsigned>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+inline BigInt::BigInt(std::string_view text) : negative(false) {
+    size_t position = 0;
+    bool minus = false;
+    if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+        minus = text[0] == '-';
+        ++position;
+    }
+    if (position == text.size()) {
+        throw std::invalid_argument("Not an integer");
+    }
+    // Nine decimal digits fit into one limb multiplication.
+    while (position < text.size()) {
+        unsigned chunk = 0;
+        unsigned scale = 1;
+        for (size_t digits = 0; digits < 9 && position < text.size(); ++digits, ++position) {
+            if (text[position] < '0' || text[position] > '9') {
+                throw std::invalid_argument("Not an integer");
+            }
+            chunk = chunk * 10 + static_cast<unsigned>(text[position] - '0');
+            scale *= 10;
+        }
+        MultiplyAdd(scale, chunk);
+    }
+    negative = minus && !limbs.empty();
+}
+
+inline void BigInt::Trim() {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    if (limbs.empty()) {
+        negative = false;
+    }
+}
+
+inline int BigInt::CompareMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+    for (size_t index = lhs.size(); index-- > 0;) {
+        if (lhs[index] != rhs[index]) {
+            return lhs[index] < rhs[index] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+inline void BigInt::AddMagnitude(Limbs& lhs, const Limbs& rhs) {
+    if (lhs.size() < rhs.size()) {
+        lhs.resize(rhs.size(), 0);
+    }
+    unsigned long long carry = 0;
+    for (size_t index = 0; index < lhs.size() && (index < rhs.size() || carry); ++index) {
+        carry += lhs[index];
+        if (index < rhs.size()) {
+            carry += rhs[index];
+        }
+        lhs[index] = static_cast<unsigned>(carry);
+        carry >>= 32;
+    }
+    if (carry) {
+        lhs.push_back(static_cast<unsigned>(carry));
+    }
+}
+
+inline void BigInt::SubtractMagnitude(Limbs& lhs, const Limbs& rhs) {
+    long long borrow = 0;
+    for (size_t index = 0; index < lhs.size(); ++index) {
+        long long difference = static_cast<long long>(lhs[index]) + borrow;
+        if (index < rhs.size()) {
+            difference -= rhs[index];
+        } else if (borrow == 0) {
+            break;
+        }
+        borrow = difference < 0 ? -1 : 0;
+        lhs[index] = static_cast<unsigned>(difference);
+    }
+}
+
+inline BigInt::Limbs BigInt::MultiplyMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.empty() || rhs.empty()) {
+        return Limbs();
+    }
+    Limbs product(lhs.size() + rhs.size(), 0);
+    for (size_t index = 0; index < lhs.size(); ++index) {
+        unsigned long long carry = 0;
+        for (size_t other = 0; other < rhs.size(); ++other) {
+            carry += static_cast<unsigned long long>(lhs[index]) * rhs[other] + product[index + other];
+            product[index + other] = static_cast<unsigned>(carry);
+            carry >>= 32;
+        }
+        product[index + rhs.size()] = static_cast<unsigned>(carry);
+    }
+    return product;
+}
+
+inline unsigned BigInt::DivideSmall(Limbs& magnitude, unsigned divisor) {
+    unsigned long long rest = 0;
+    for (size_t index = magnitude.size(); index-- > 0;) {
+        rest = rest << 32 | magnitude[index];
+        magnitude[index] = static_cast<unsigned>(rest / divisor);
+        rest %= divisor;
+    }
+    while (!magnitude.empty() && magnitude.back() == 0) {
+        magnitude.pop_back();
+    }
+    return static_cast<unsigned>(rest);
+}
+
+// Knuth's algorithm D: the divisor is normalized so that its top limb has the
+// high bit set, then every quotient limb estimated from the top two limbs of
+// the remainder is off by at most two and fixed by an add-back.
+inline void BigInt::DivideMagnitude(const Limbs& dividend, const Limbs& divisor, Limbs& quotient, Limbs& remainder) {
+    if (divisor.empty()) {
+        throw std::overflow_error("Divide by zero");
+    }
+    if (CompareMagnitude(dividend, divisor) < 0) {
+        quotient.clear();
+        remainder = dividend;
+        return;
+    }
+    if (divisor.size() == 1) {
+        quotient = dividend;
+        unsigned rest = DivideSmall(quotient, divisor[0]);
+        remainder.assign(rest ? 1 : 0, rest);
+        return;
+    }
+
+    int shift = 0;
+    while ((divisor.back() << shift & 0x80000000u) == 0) {
+        ++shift;
+    }
+    auto normalize = [shift](const Limbs& source, size_t size) {
+        Limbs result(size, 0);
+        for (size_t index = 0; index < source.size(); ++index) {
+            unsigned long long value = static_cast<unsigned long long>(source[index]) << shift;
+            result[index] |= static_cast<unsigned>(value);
+            if (index + 1 < size) {
+                result[index + 1] |= static_cast<unsigned>(value >> 32);
+            }
+        }
+        return result;
+    };
+    size_t size = divisor.size();
+    Limbs top = normalize(divisor, size);
+    Limbs rest = normalize(dividend, dividend.size() + 1);
+
+    const unsigned long long base = 1ULL << 32;
+    quotient.assign(dividend.size() - size + 1, 0);
+    for (size_t position = quotient.size(); position-- > 0;) {
+        unsigned long long numerator = static_cast<unsigned long long>(rest[position + size]) << 32
+            | rest[position + size - 1];
+        unsigned long long estimate = numerator / top[size - 1];
+        unsigned long long estimate_rest = numerator % top[size - 1];
+        while (estimate >= base
+               || estimate * top[size - 2] > (estimate_rest << 32 | rest[position + size - 2])) {
+            --estimate;
+            estimate_rest += top[size - 1];
+            if (estimate_rest >= base) {
+                break;
+            }
+        }
+
+        unsigned long long carry = 0;
+        long long borrow = 0;
+        for (size_t index = 0; index < size; ++index) {
+            unsigned long long product = estimate * top[index] + carry;
+            carry = product >> 32;
+            long long difference = static_cast<long long>(rest[position + index])
+                - static_cast<long long>(product & 0xffffffffu) + borrow;
+            rest[position + index] = static_cast<unsigned>(difference);
+            borrow = difference < 0 ? -1 : 0;
+        }
+        long long difference = static_cast<long long>(rest[position + size]) - static_cast<long long>(carry) + borrow;
+        rest[position + size] = static_cast<unsigned>(difference);
+
+        if (difference < 0) {
+            --estimate;
+            unsigned long long sum = 0;
+            for (size_t index = 0; index < size; ++index) {
+                sum += static_cast<unsigned long long>(rest[position + index]) + top[index];
+                rest[position + index] = static_cast<unsigned>(sum);
+                sum >>= 32;
+            }
+            rest[position + size] += static_cast<unsigned>(sum);
+        }
+        quotient[position] = static_cast<unsigned>(estimate);
+    }
+    while (!quotient.empty() && quotient.back() == 0) {
+        quotient.pop_back();
+    }
+
+    remainder.assign(size, 0);
+    for (size_t index = 0; index < size; ++index) {
+        unsigned long long value = (static_cast<unsigned long long>(rest[index + 1]) << 32 | rest[index]) >> shift;
+        remainder[index] = static_cast<unsigned>(value);
+    }
+    while (!remainder.empty() && remainder.back() == 0) {
+        remainder.pop_back();
+    }
+}
+
+inline BigInt& BigInt::AddSigned(const BigInt& other, bool subtract) {
+    bool other_negative = other.negative != subtract && !other.limbs.empty();
+    if (negative == other_negative) {
+        AddMagnitude(limbs, other.limbs);
+    } else if (CompareMagnitude(limbs, other.limbs) >= 0) {
+        SubtractMagnitude(limbs, other.limbs);
+    } else {
+        Limbs magnitude(other.limbs);
+        SubtractMagnitude(magnitude, limbs);
+        limbs.swap(magnitude);
+        negative = other_negative;
+    }
+    Trim();
+    return *this;
+}
+
+inline bool BigInt::IsZero() const {
+    return limbs.empty();
+}
+
+inline bool BigInt::IsNegative() const {
+    return negative;
+}
+
+inline size_t BigInt::BitLength() const {
+    if (limbs.empty()) {
+        return 0;
+    }
+    size_t length = 32 * (limbs.size() - 1);
+    for (unsigned top = limbs.back(); top > 0; top >>= 1) {
+        ++length;
+    }
+    return length;
+}
+
+inline unsigned BigInt::Modulo(unsigned modulus) const {
+    unsigned long long rest = 0;
+    for (size_t index = limbs.size(); index-- > 0;) {
+        rest = (rest << 32 | limbs[index]) % modulus;
+    }
+    return negative && rest != 0 ? static_cast<unsigned>(modulus - rest) : static_cast<unsigned>(rest);
+}
+
+inline BigInt& BigInt::MultiplyAdd(unsigned factor, unsigned addend) {
+    unsigned long long carry = addend;
+    for (size_t index = 0; index < limbs.size(); ++index) {
+        carry += static_cast<unsigned long long>(limbs[index]) * factor;
+        limbs[index] = static_cast<unsigned>(carry);
+        carry >>= 32;
+    }
+    if (carry) {
+        limbs.push_back(static_cast<unsigned>(carry));
+    }
+    Trim();
+    return *this;
+}
+
+inline BigInt::operator double() const {
+    double result = 0;
+    for (size_t index = limbs.size(); index-- > 0;) {
+        result = result * 4294967296.0 + limbs[index];
+    }
+    return negative ? -result : result;
+}
+
+inline std::string BigInt::ToString() const {
+    if (limbs.empty()) {
+        return "0";
+    }
+    Limbs magnitude(limbs);
+    std::string digits;
+    while (!magnitude.empty()) {
+        unsigned chunk = DivideSmall(magnitude, 1000000000u);
+        for (int digit = 0; digit < 9 && (chunk > 0 || !magnitude.empty()); ++digit) {
+            digits.push_back(static_cast<char>('0' + chunk % 10));
+            chunk /= 10;
+        }
+    }
+    if (negative) {
+        digits.push_back('-');
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+inline BigInt BigInt::operator -() const {
+    BigInt result(*this);
+    result.negative = !negative && !limbs.empty();
+    return result;
+}
+
+inline BigInt& BigInt::operator +=(const BigInt& other) {
+    return AddSigned(other, false);
+}
+
+inline BigInt& BigInt::operator -=(const BigInt& other) {
+    return AddSigned(other, true);
+}
+
+inline BigInt& BigInt::operator *=(const BigInt& other) {
+    return *this = *this * other;
+}
+
+inline BigInt& BigInt::operator /=(const BigInt& other) {
+    Limbs quotient, remainder;
+    DivideMagnitude(limbs, other.limbs, quotient, remainder);
+    limbs.swap(quotient);
+    negative = negative != other.negative;
+    Trim();
+    return *this;
+}
+
+inline BigInt& BigInt::operator %=(const BigInt& other) {
+    Limbs quotient, remainder;
+    DivideMagnitude(limbs, other.limbs, quotient, remainder);
+    limbs.swap(remainder);
+    Trim();
+    return *this;
+}
+
+inline void AddMonomial(const BigInt& coef, int degree, std::ostream& stream, bool isFirst) {
+    if (coef.IsZero()) {
+        if (degree == 0 && isFirst) {
+            stream << coef;
+        }
+        return;
+    }
+
+    if (coef.IsNegative()) {
+        stream << " - ";
+    } else if (!isFirst) {
+        stream << " + ";
+    }
+    BigInt magnitude = coef.IsNegative() ? -coef : coef;
+    if (degree == 0 || magnitude != BigInt(1)) {
+        stream << magnitude;
+    }
+    if (degree != 0) {
+        stream << "x";
+        if (degree != 1) {
+            stream << "^" << degree;
+        }
+    }
+}
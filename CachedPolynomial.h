@@ -0,0 +1,109 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+#include "Polynomial.h"
+
+
+struct EvaluationCacheThresholds {
+    // Recent points whose values CachedPolynomial keeps, each with its powers
+    // up to the degree.
+    static inline size_t capacity = 16;
+};
+
+// Polynomial that remembers its values at the points it was recently evaluated
+// at, and at a fixed set of points given on construction, together with the
+// powers of every such point. A write of one coefficient through operator[]
+// changes x^k's coefficient by some delta and so updates each remembered value
+// by delta * x^k instead of evaluating again. All members lock one mutex, so
+// evaluations and writes may come from several threads; values of floating
+// point polynomials collect the rounding of the updates until Refresh().
+template<class T>
+class CachedPolynomial {
+private:
+    struct Entry {
+        T point;
+        T value;
+        // point^0, point^1, ..., extended when a write reaches a higher power.
+        std::vector<T> powers;
+        unsigned long long last_use;
+    };
+
+    Polynomial<T> polynomial;
+    size_t capacity;
+    // The first fixed entries are the points given on construction and are
+    // never evicted; the recent points follow them.
+    size_t fixed;
+    mutable std::vector<Entry> entries;
+    mutable unsigned long long clock;
+    mutable std::mutex mutex;
+
+    // Coefficient of x^index, zero above the degree; the caller holds the lock.
+    T Coefficient(size_t index) const;
+
+    Entry MakeEntry(const T& point) const;
+
+    static const T& Power(Entry& entry, size_t exponent);
+
+    template<class Function>
+    void Modify(size_t index, const Function& function);
+
+public:
+    typedef T value_type;
+
+    // Writable coefficient handle returned by the non-const operator[]; reads
+    // give a copy, as the coefficient may change under another thread.
+    class Reference {
+    private:
+        CachedPolynomial<T>* cached;
+        size_t index;
+
+    public:
+        Reference(CachedPolynomial<T>* cached, size_t index);
+
+        operator T() const;
+
+        Reference& operator =(const T& value);
+        Reference& operator =(const Reference& other);
+        Reference& operator +=(const T& value);
+        Reference& operator -=(const T& value);
+        Reference& operator *=(const T& value);
+        Reference& operator /=(const T& value);
+    };
+
+    explicit CachedPolynomial(const Polynomial<T>& polynomial = Polynomial<T>(),
+                              size_t capacity = EvaluationCacheThresholds::capacity);
+
+    CachedPolynomial(const Polynomial<T>& polynomial, const std::vector<T>& points,
+                     size_t capacity = EvaluationCacheThresholds::capacity);
+
+    CachedPolynomial(const CachedPolynomial<T>&) = delete;
+    CachedPolynomial<T>& operator =(const CachedPolynomial<T>&) = delete;
+
+    T operator[](size_t) const;
+    Reference operator[](size_t);
+
+    // Value at a remembered point, or Horner's value remembered in place of
+    // the least recently used point.
+    T operator()(const T&) const;
+
+    // Value at points[index] of the fixed set.
+    T Value(size_t index) const;
+    std::vector<T> Values() const;
+
+    int Degree() const;
+
+    Polynomial<T> Snapshot() const;
+
+    void Assign(const Polynomial<T>&);
+
+    // Evaluates every remembered point again.
+    void Refresh();
+
+    // Recent points remembered, not counting the fixed set.
+    size_t CachedPoints() const;
+};
+
+#include "CachedPolynomial.hpp"
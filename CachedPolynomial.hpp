@@ -0,0 +1,211 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+
+#include "Stats.hpp"
+
+
+template<class T>
+CachedPolynomial<T>::CachedPolynomial(const Polynomial<T>& polynomial, size_t capacity)
+    : polynomial(polynomial), capacity(capacity), fixed(0), clock(0) {}
+
+template<class T>
+CachedPolynomial<T>::CachedPolynomial(const Polynomial<T>& polynomial, const std::vector<T>& points, size_t capacity)
+    : polynomial(polynomial), capacity(capacity), fixed(points.size()), clock(0) {
+    entries.reserve(points.size());
+    for (const T& point : points) {
+        entries.push_back(MakeEntry(point));
+    }
+}
+
+template<class T>
+T CachedPolynomial<T>::Coefficient(size_t index) const {
+    if (index > static_cast<size_t>(polynomial.Degree())) {
+        return T();
+    }
+    return polynomial[index];
+}
+
+// The value comes from Horner's rule, so a fresh entry agrees exactly with
+// Polynomial::operator(); the powers are only needed by later writes.
+template<class T>
+typename CachedPolynomial<T>::Entry CachedPolynomial<T>::MakeEntry(const T& point) const {
+    Entry entry{point, polynomial(point), std::vector<T>(), clock};
+    size_t size = polynomial.Degree() + 1;
+    entry.powers.reserve(size);
+    entry.powers.push_back(T(1));
+    while (entry.powers.size() < size) {
+        entry.powers.push_back(entry.powers.back() * point);
+    }
+    return entry;
+}
+
+template<class T>
+const T& CachedPolynomial<T>::Power(Entry& entry, size_t exponent) {
+    while (entry.powers.size() <= exponent) {
+        entry.powers.push_back(entry.powers.back() * entry.point);
+    }
+    return entry.powers[exponent];
+}
+
+template<class T>
+template<class Function>
+void CachedPolynomial<T>::Modify(size_t index, const Function& function) {
+    std::lock_guard<std::mutex> lock(mutex);
+    T old = Coefficient(index);
+    T value = function(old);
+    polynomial[index] = value;
+    T delta = value - old;
+    if (delta == T()) {
+        return;
+    }
+    CountStat(StatCounter::CoefficientMultiplies, entries.size());
+    for (Entry& entry : entries) {
+        entry.value += delta * Power(entry, index);
+    }
+}
+
+template<class T>
+CachedPolynomial<T>::Reference::Reference(CachedPolynomial<T>* cached, size_t index)
+    : cached(cached), index(index) {}
+
+template<class T>
+CachedPolynomial<T>::Reference::operator T() const {
+    std::lock_guard<std::mutex> lock(cached->mutex);
+    return cached->Coefficient(index);
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator =(const T& value) {
+    cached->Modify(index, [&value](const T&) { return value; });
+    return *this;
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator =(const Reference& other) {
+    return *this = static_cast<T>(other);
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator +=(const T& value) {
+    cached->Modify(index, [&value](const T& old) { return old + value; });
+    return *this;
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator -=(const T& value) {
+    cached->Modify(index, [&value](const T& old) { return old - value; });
+    return *this;
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator *=(const T& value) {
+    cached->Modify(index, [&value](const T& old) { return old * value; });
+    return *this;
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference& CachedPolynomial<T>::Reference::operator /=(const T& value) {
+    cached->Modify(index, [&value](const T& old) { return old / value; });
+    return *this;
+}
+
+template<class T>
+T CachedPolynomial<T>::operator[](size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Coefficient(index);
+}
+
+template<class T>
+typename CachedPolynomial<T>::Reference CachedPolynomial<T>::operator[](size_t index) {
+    return Reference(this, index);
+}
+
+template<class T>
+T CachedPolynomial<T>::operator()(const T& point) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++clock;
+    size_t oldest = entries.size();
+    for (size_t index = 0; index < entries.size(); ++index) {
+        if (entries[index].point == point) {
+            CountStat(StatCounter::CachedEvaluations);
+            entries[index].last_use = clock;
+            return entries[index].value;
+        }
+        if (index >= fixed && (oldest == entries.size() || entries[index].last_use < entries[oldest].last_use)) {
+            oldest = index;
+        }
+    }
+    if (capacity == 0) {
+        return polynomial(point);
+    }
+
+    Entry entry = MakeEntry(point);
+    T value = entry.value;
+    if (entries.size() - fixed < capacity) {
+        entries.push_back(std::move(entry));
+    } else {
+        entries[oldest] = std::move(entry);
+    }
+    return value;
+}
+
+template<class T>
+T CachedPolynomial<T>::Value(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index >= fixed) {
+        throw std::out_of_range("No such fixed point");
+    }
+    CountStat(StatCounter::CachedEvaluations);
+    return entries[index].value;
+}
+
+template<class T>
+std::vector<T> CachedPolynomial<T>::Values() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    CountStat(StatCounter::CachedEvaluations, fixed);
+    std::vector<T> values;
+    values.reserve(fixed);
+    for (size_t index = 0; index < fixed; ++index) {
+        values.push_back(entries[index].value);
+    }
+    return values;
+}
+
+template<class T>
+int CachedPolynomial<T>::Degree() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return polynomial.Degree();
+}
+
+template<class T>
+Polynomial<T> CachedPolynomial<T>::Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return polynomial;
+}
+
+// The powers depend on the points only, so a new polynomial keeps them.
+template<class T>
+void CachedPolynomial<T>::Assign(const Polynomial<T>& other) {
+    std::lock_guard<std::mutex> lock(mutex);
+    polynomial = other;
+    for (Entry& entry : entries) {
+        entry.value = polynomial(entry.point);
+    }
+}
+
+template<class T>
+void CachedPolynomial<T>::Refresh() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Entry& entry : entries) {
+        entry.value = polynomial(entry.point);
+    }
+}
+
+template<class T>
+size_t CachedPolynomial<T>::CachedPoints() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size() - fixed;
+}
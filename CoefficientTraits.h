@@ -0,0 +1,19 @@
+#pragma once
+#include <type_traits>
+
+
+template<class T>
+struct CoefficientTraits {
+    static const bool is_field = std::is_floating_point<T>::value;
+    static const bool is_exact = !std::is_floating_point<T>::value;
+};
+
+// Products and gcds of coefficient vectors that a coefficient type provides
+// itself, specialized next to the type as BigInt does; the generic algorithms
+// only call Multiply and Gcd where the matching flag is set. Multiply returns
+// false to leave the product to them.
+template<class T>
+struct CoefficientAlgorithms {
+    static const bool has_multiply = false;
+    static const bool has_gcd = false;
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "Arena.hpp"
+#include "CoefficientTraits.h"
+#include "Multiplication.hpp"
+#include "Gcd.hpp"
+
+using std::vector;
+
+
+struct CompositionThresholds {
+    static inline size_t horner = 16;
+    static inline size_t taylor_shift = 64;
+};
+
+// outer(inner) by Horner's rule over polynomials.
+template<class T>
+ArenaVector<T> HornerCompose(const T* outer, size_t size, const ArenaVector<T>& inner) {
+    ArenaVector<T> result(1, outer[size - 1]);
+    for (size_t index = size - 1; index-- > 0;) {
+        result = MultiplyPolynomials(result, inner);
+        result[0] += outer[index];
+        TrimCoefficients(result);
+    }
+    return result;
+}
+
+// Splits outer at the largest power of two 2^k below its size, so that
+// outer(inner) = low(inner) + inner^(2^k) high(inner) with powers[k] = inner^(2^k).
+template<class T>
+ArenaVector<T> SplitCompose(const T* outer, size_t size, const ArenaVector<ArenaVector<T> >& powers) {
+    if (size <= std::max<size_t>(CompositionThresholds::horner, 1)) {
+        return HornerCompose(outer, size, powers[0]);
+    }
+    size_t level = 0;
+    while ((size_t(2) << level) < size) {
+        ++level;
+    }
+    size_t half = size_t(1) << level;
+
+    ArenaVector<T> result = SplitCompose(outer, half, powers);
+    AddPolynomials(result, MultiplyPolynomials(SplitCompose(outer + half, size - half, powers), powers[level]), false);
+    return result;
+}
+
+template<class T>
+ArenaVector<T> ComposeCoefficients(const T* outer, size_t size, const ArenaVector<T>& inner) {
+    ArenaVector<ArenaVector<T> > powers(1, inner);
+    while ((size_t(1) << powers.size()) < size) {
+        powers.push_back(MultiplyPolynomials(powers.back(), powers.back()));
+    }
+    return SplitCompose(outer, size, powers);
+}
+
+// Repeated synthetic division by x - shift, O(n^2) operations.
+template<class T>
+void NaiveTaylorShift(T* coefficients, size_t size, const T& shift) {
+    for (size_t step = 0; step + 1 < size; ++step) {
+        for (size_t index = size - 1; index-- > step;) {
+            coefficients[index] += shift * coefficients[index + 1];
+        }
+    }
+}
+
+// With b_i = i! p_i and c_j = shift^j / j!, the coefficient of x^k in
+// p(x + shift) is (1 / k!) sum_i b_i c_(i - k): one product of b reversed with
+// c. Returns false when some k! vanishes, as it does modulo a small prime.
+template<class T>
+bool ConvolutionTaylorShift(T* coefficients, size_t size, const T& shift) {
+    ArenaVector<T> factorials(size);
+    factorials[0] = T(1);
+    for (size_t index = 1; index < size; ++index) {
+        factorials[index] = factorials[index - 1] * T(static_cast<int>(index));
+        if (factorials[index] == T()) {
+            return false;
+        }
+    }
+
+    ArenaVector<T> scaled(size);
+    ArenaVector<T> powers(size);
+    T inverse_factorial = T(1) / factorials[size - 1];
+    ArenaVector<T> inverse_factorials(size);
+    for (size_t index = size; index-- > 0;) {
+        inverse_factorials[index] = inverse_factorial;
+        inverse_factorial *= T(static_cast<int>(index));
+    }
+    T power = T(1);
+    for (size_t index = 0; index < size; ++index) {
+        scaled[size - 1 - index] = coefficients[index] * factorials[index];
+        powers[index] = power * inverse_factorials[index];
+        power *= shift;
+    }
+
+    ArenaVector<T> product(2 * size - 1);
+    MultiplyCoefficients(&scaled[0], size, &powers[0], size, &product[0]);
+    for (size_t index = 0; index < size; ++index) {
+        coefficients[index] = product[size - 1 - index] * inverse_factorials[index];
+    }
+    return true;
+}
+
+// p(x + shift) in place. Exact fields use the convolution; other coefficient
+// types compose with x + shift, which needs no division, and doubles take
+// that route too because i! p_i overflows past degree 170.
+template<class T>
+void TaylorShiftCoefficients(ArenaVector<T>& coefficients, const T& shift) {
+    size_t size = coefficients.size();
+    if (size < CompositionThresholds::taylor_shift) {
+        NaiveTaylorShift(&coefficients[0], size, shift);
+        return;
+    }
+    if constexpr (CoefficientTraits<T>::is_field && CoefficientTraits<T>::is_exact) {
+        if (ConvolutionTaylorShift(&coefficients[0], size, shift)) {
+            return;
+        }
+    }
+    ArenaVector<T> linear(2, T(1));
+    linear[0] = shift;
+    coefficients = ComposeCoefficients(&coefficients[0], size, linear);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "Arena.hpp"
+#include "CoefficientTraits.h"
+#include "ModInt.h"
+#include "Multiplication.hpp"
+#include "Stats.hpp"
+
+using std::vector;
+
+
+struct DivisionThresholds {
+    static inline size_t newton = 1500;
+};
+
+template<class T>
+size_t LongDivide(T* remainder, size_t size, const T* divisor, size_t divisor_size, T* quotient) {
+    const T& lead = divisor[divisor_size - 1];
+    size_t quotient_size = size - divisor_size + 1;
+    std::fill(quotient, quotient + quotient_size, T());
+
+    // Residues divide by one multiplication with the inverse computed here.
+    T lead_inverse = lead;
+    if constexpr (IsModInt<T>::value) {
+        lead_inverse = lead.Inverse();
+    }
+
+    for (size_t index = quotient_size; index-- > 0;) {
+        T& current = remainder[index + divisor_size - 1];
+        if (current == T()) {
+            continue;
+        }
+
+        T coef;
+        if constexpr (IsModInt<T>::value) {
+            coef = current * lead_inverse;
+        } else {
+            coef = current / lead;
+        }
+        if (coef == T()) {
+            return index + divisor_size;
+        }
+        quotient[index] = coef;
+        CountStat(StatCounter::CoefficientMultiplies, divisor_size);
+
+        for (size_t other = 0; other + 1 < divisor_size; ++other) {
+            remainder[index + other] -= coef * divisor[other];
+        }
+
+        if (CoefficientTraits<T>::is_field) {
+            current = T();
+        } else {
+            current -= coef * lead;
+            if (current != T()) {
+                return index + divisor_size;
+            }
+        }
+    }
+
+    return divisor_size - 1;
+}
+
+template<class T>
+void TruncatedMultiply(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, size_t size, ArenaVector<T>& out) {
+    lhs_size = std::min(lhs_size, size);
+    rhs_size = std::min(rhs_size, size);
+    out.resize(lhs_size + rhs_size - 1);
+    MultiplyCoefficients(lhs, lhs_size, rhs, rhs_size, &out[0]);
+    out.resize(size);
+}
+
+template<class T>
+void ReciprocalSeries(const T* series, size_t series_size, size_t size, ArenaVector<T>& reciprocal) {
+    reciprocal.assign(1, T(1) / series[0]);
+    ArenaVector<T> correction;
+    ArenaVector<T> next;
+    for (size_t length = 1; length < size;) {
+        length = std::min(2 * length, size);
+        TruncatedMultiply(series, series_size, &reciprocal[0], reciprocal.size(), length, correction);
+        for (size_t index = 0; index < length; ++index) {
+            correction[index] = -correction[index];
+        }
+        correction[0] += T(2);
+        TruncatedMultiply(&reciprocal[0], reciprocal.size(), &correction[0], length, length, next);
+        reciprocal.swap(next);
+    }
+}
+
+template<class T>
+bool HasUnitInverse(const T& lead) {
+    if constexpr (std::is_integral<T>::value) {
+        return lead == T(1) || lead == T(-1);
+    } else {
+        return CoefficientTraits<T>::is_field;
+    }
+}
+
+template<class T>
+size_t NewtonDivide(T* remainder, size_t size, const T* divisor, size_t divisor_size, T* quotient) {
+    size_t quotient_size = size - divisor_size + 1;
+
+    ArenaVector<T> reversed_divisor(divisor, divisor + divisor_size);
+    std::reverse(reversed_divisor.begin(), reversed_divisor.end());
+    ArenaVector<T> reciprocal;
+    ReciprocalSeries(&reversed_divisor[0], divisor_size, quotient_size, reciprocal);
+
+    ArenaVector<T> reversed_dividend(remainder + size - quotient_size, remainder + size);
+    std::reverse(reversed_dividend.begin(), reversed_dividend.end());
+    ArenaVector<T> reversed_quotient;
+    TruncatedMultiply(&reversed_dividend[0], quotient_size, &reciprocal[0], quotient_size,
+                      quotient_size, reversed_quotient);
+    std::reverse_copy(reversed_quotient.begin(), reversed_quotient.end(), quotient);
+
+    size_t remainder_size = divisor_size - 1;
+    ArenaVector<T> product;
+    TruncatedMultiply(divisor, divisor_size, quotient, quotient_size, std::max<size_t>(remainder_size, 1), product);
+    for (size_t index = 0; index < remainder_size; ++index) {
+        remainder[index] -= product[index];
+    }
+    return remainder_size;
+}
+
+template<class T>
+size_t DivideCoefficients(T* remainder, size_t size, const T* divisor, size_t divisor_size, T* quotient) {
+    size_t quotient_size = size - divisor_size + 1;
+    if (std::min(quotient_size, divisor_size) >= DivisionThresholds::newton
+        && HasUnitInverse(divisor[divisor_size - 1])) {
+        CountStat(StatCounter::NewtonDivision);
+        return NewtonDivide(remainder, size, divisor, divisor_size, quotient);
+    }
+    CountStat(StatCounter::LongDivision);
+    return LongDivide(remainder, size, divisor, divisor_size, quotient);
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "Arena.hpp"
+#include "CoefficientTraits.h"
+#include "Multiplication.hpp"
+#include "Division.hpp"
+#include "Simd.hpp"
+#include "Stats.hpp"
+
+using std::vector;
+
+
+struct EvaluationThresholds {
+    static inline size_t subproduct_tree = 16384;
+    static inline size_t tree_leaf = 64;
+};
+
+template<class T>
+T HornerValue(const T* coefficients, size_t size, const T& point) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        return static_cast<T>(HornerValue(reinterpret_cast<const U*>(coefficients), size, static_cast<U>(point)));
+    }
+    CountStat(StatCounter::CoefficientMultiplies, size - 1);
+    T value = coefficients[size - 1];
+    for (size_t index = size - 1; index-- > 0;) {
+        value = value * point + coefficients[index];
+    }
+    return value;
+}
+
+template<class T>
+void HornerEvaluate(const T* coefficients, size_t size, const T* points, size_t count, T* values) {
+    HornerCoefficients(coefficients, size, points, count, values);
+}
+
+template<class T>
+void RemainderModulo(ArenaVector<T>& remainder, const ArenaVector<T>& modulus, ArenaVector<T>& scratch) {
+    if (remainder.size() < modulus.size()) {
+        return;
+    }
+    scratch.resize(remainder.size() - modulus.size() + 1);
+    size_t remainder_size = DivideCoefficients(&remainder[0], remainder.size(),
+                                               &modulus[0], modulus.size(), &scratch[0]);
+    remainder.resize(std::max<size_t>(remainder_size, 1));
+}
+
+// Node of the subproduct tree covering points [begin, end) is the monic
+// product of (x - point) over the range; leaves cover tree_leaf points.
+template<class T>
+void BuildSubproductTree(const T* points, size_t begin, size_t end, size_t node, ArenaVector<ArenaVector<T> >& tree) {
+    ArenaVector<T>& product = tree[node];
+    if (end - begin <= EvaluationThresholds::tree_leaf) {
+        product.assign(1, T(1));
+        for (size_t index = begin; index < end; ++index) {
+            product.push_back(T(1));
+            for (size_t power = product.size() - 2; power > 0; --power) {
+                product[power] = product[power - 1] - points[index] * product[power];
+            }
+            product[0] = T() - points[index] * product[0];
+        }
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    BuildSubproductTree(points, begin, middle, 2 * node, tree);
+    BuildSubproductTree(points, middle, end, 2 * node + 1, tree);
+    const ArenaVector<T>& left = tree[2 * node];
+    const ArenaVector<T>& right = tree[2 * node + 1];
+    product.resize(left.size() + right.size() - 1);
+    MultiplyCoefficients(&left[0], left.size(), &right[0], right.size(), &product[0]);
+}
+
+template<class T>
+void DescendSubproductTree(ArenaVector<T> remainder, const T* points, size_t begin, size_t end, size_t node,
+                           const ArenaVector<ArenaVector<T> >& tree, T* values, ArenaVector<T>& scratch) {
+    RemainderModulo(remainder, tree[node], scratch);
+    if (end - begin <= EvaluationThresholds::tree_leaf) {
+        HornerEvaluate(&remainder[0], remainder.size(), points + begin, end - begin, values + begin);
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    DescendSubproductTree(remainder, points, begin, middle, 2 * node, tree, values, scratch);
+    DescendSubproductTree(std::move(remainder), points, middle, end, 2 * node + 1, tree, values, scratch);
+}
+
+// Fast multipoint evaluation: f mod prod(x - point) is pushed down the tree,
+// so every point is reached with a remainder of degree below its leaf size.
+// The points are processed in chunks of about deg f, which keeps the tree
+// balanced against the polynomial when there are many more points.
+template<class T>
+void SubproductTreeEvaluate(const T* coefficients, size_t size, const T* points, size_t count, T* values) {
+    size_t chunk = std::max(size, EvaluationThresholds::tree_leaf);
+    ArenaVector<ArenaVector<T> > tree;
+    ArenaVector<T> scratch;
+    for (size_t offset = 0; offset < count; offset += chunk) {
+        size_t chunk_count = std::min(chunk, count - offset);
+        tree.assign(4 * (chunk_count / EvaluationThresholds::tree_leaf + 1), ArenaVector<T>());
+        BuildSubproductTree(points + offset, 0, chunk_count, 1, tree);
+        DescendSubproductTree(ArenaVector<T>(coefficients, coefficients + size), points + offset, 0, chunk_count, 1,
+                              tree, values + offset, scratch);
+    }
+}
+
+// The subproduct tree relies on exact cancellation in the remainders, so
+// floating-point polynomials always use Horner's scheme.
+template<class T>
+void EvaluateCoefficients(const T* coefficients, size_t size, const T* points, size_t count, T* values) {
+    if constexpr (CoefficientTraits<T>::is_exact) {
+        if (std::min(size, count) >= EvaluationThresholds::subproduct_tree) {
+            SubproductTreeEvaluate(coefficients, size, points, count, values);
+            return;
+        }
+    }
+    HornerEvaluate(coefficients, size, points, count, values);
+}
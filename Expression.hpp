@@ -0,0 +1,285 @@
+#pragma once
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+template<class T>
+class Polynomial;
+
+// Lazy sums, differences and scalar multiples of polynomials. A node only
+// describes the coefficients of the result; they are computed in a single pass
+// when the node is assigned to a Polynomial<T>, and operator() evaluates the
+// node without building its coefficients at all. Temporaries are owned by the
+// node, so the first of them large enough becomes the output buffer.
+struct PolynomialExpressionTag {};
+
+template<class T, class Derived>
+class PolynomialExpression : public PolynomialExpressionTag {
+public:
+    typedef T value_type;
+};
+
+template<class X>
+struct IsPolynomialExpression : std::is_base_of<PolynomialExpressionTag, typename std::decay<X>::type> {};
+
+template<class X>
+struct IsPolynomial : std::false_type {};
+
+template<class T>
+struct IsPolynomial<Polynomial<T> > : std::true_type {};
+
+template<class X>
+struct IsPolynomialOperand
+    : std::integral_constant<bool, IsPolynomialExpression<X>::value
+                                   || IsPolynomial<typename std::decay<X>::type>::value> {};
+
+template<class X, class = void>
+struct CoefficientOf {};
+
+template<class X>
+struct CoefficientOf<X, typename std::enable_if<IsPolynomialOperand<X>::value>::type> {
+    typedef typename std::decay<X>::type::value_type type;
+};
+
+template<class T>
+class PolynomialReference : public PolynomialExpression<T, PolynomialReference<T> > {
+private:
+    const Polynomial<T>* polynomial;
+    size_t size;
+
+public:
+    explicit PolynomialReference(const Polynomial<T>& polynomial)
+        : polynomial(&polynomial), size(polynomial.Degree() + 1) {}
+
+    const Polynomial<T>& Referenced() const {
+        return *polynomial;
+    }
+
+    size_t Size() const {
+        return size;
+    }
+
+    T Coefficient(size_t index) const {
+        return index < size ? polynomial->coefficients[index] : T();
+    }
+
+    Polynomial<T>* Reusable(size_t) {
+        return 0;
+    }
+
+    T operator()(const T& arg) const {
+        return (*polynomial)(arg);
+    }
+};
+
+template<class T>
+class PolynomialValue : public PolynomialExpression<T, PolynomialValue<T> > {
+private:
+    Polynomial<T> polynomial;
+    size_t size;
+
+public:
+    explicit PolynomialValue(Polynomial<T> value)
+        : polynomial(std::move(value)), size(polynomial.Degree() + 1) {}
+
+    size_t Size() const {
+        return size;
+    }
+
+    T Coefficient(size_t index) const {
+        return index < size ? polynomial.coefficients[index] : T();
+    }
+
+    Polynomial<T>* Reusable(size_t result_size) {
+        return polynomial.coefficients.capacity() >= result_size ? &polynomial : 0;
+    }
+
+    T operator()(const T& arg) const {
+        return polynomial(arg);
+    }
+};
+
+template<class T, class L, class R, bool Subtract>
+class SumExpression : public PolynomialExpression<T, SumExpression<T, L, R, Subtract> > {
+private:
+    L lhs;
+    R rhs;
+
+public:
+    SumExpression(L&& lhs, R&& rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+    size_t Size() const {
+        return std::max(lhs.Size(), rhs.Size());
+    }
+
+    T Coefficient(size_t index) const {
+        if (Subtract) {
+            return lhs.Coefficient(index) - rhs.Coefficient(index);
+        }
+        return lhs.Coefficient(index) + rhs.Coefficient(index);
+    }
+
+    Polynomial<T>* Reusable(size_t result_size) {
+        Polynomial<T>* buffer = lhs.Reusable(result_size);
+        return buffer ? buffer : rhs.Reusable(result_size);
+    }
+
+    T operator()(const T& arg) const {
+        if (Subtract) {
+            return lhs(arg) - rhs(arg);
+        }
+        return lhs(arg) + rhs(arg);
+    }
+};
+
+template<class T, class E>
+class ScaledExpression : public PolynomialExpression<T, ScaledExpression<T, E> > {
+private:
+    E expression;
+    T factor;
+
+public:
+    ScaledExpression(E&& expression, const T& factor) : expression(std::move(expression)), factor(factor) {}
+
+    const E& Operand() const {
+        return expression;
+    }
+
+    const T& Factor() const {
+        return factor;
+    }
+
+    size_t Size() const {
+        return expression.Size();
+    }
+
+    T Coefficient(size_t index) const {
+        return expression.Coefficient(index) * factor;
+    }
+
+    Polynomial<T>* Reusable(size_t result_size) {
+        return expression.Reusable(result_size);
+    }
+
+    T operator()(const T& arg) const {
+        return expression(arg) * factor;
+    }
+};
+
+// Polynomial lvalues are referenced, Polynomial rvalues are moved into the
+// node, nodes themselves are moved or copied.
+template<class X, bool = IsPolynomial<typename std::decay<X>::type>::value>
+struct ExpressionOperand {
+    typedef typename std::decay<X>::type type;
+};
+
+template<class X>
+struct ExpressionOperand<X, true> {
+    typedef typename std::decay<X>::type::value_type T;
+    typedef typename std::conditional<std::is_lvalue_reference<X>::value,
+                                      PolynomialReference<T>, PolynomialValue<T> >::type type;
+};
+
+template<class X>
+typename ExpressionOperand<X>::type MakeOperand(X&& operand) {
+    return typename ExpressionOperand<X>::type(std::forward<X>(operand));
+}
+
+template<class L, class R>
+struct SameCoefficients
+    : std::is_same<typename CoefficientOf<L>::type, typename CoefficientOf<R>::type> {};
+
+template<class L, class R>
+struct HasExpressionOperand
+    : std::conjunction<IsPolynomialOperand<L>, IsPolynomialOperand<R>, SameCoefficients<L, R>,
+                       std::disjunction<IsPolynomialExpression<L>, IsPolynomialExpression<R> > > {};
+
+// Two Polynomial lvalues are left to the friend operators of Polynomial<T>,
+// which also accept implicit conversions from T. A T operand has overloads of
+// its own there: converted to a temporary Polynomial, it would be referenced
+// by the node after the end of the full expression.
+template<class L, class R>
+struct IsLazySum
+    : std::conjunction<IsPolynomialOperand<L>, IsPolynomialOperand<R>, SameCoefficients<L, R>,
+                       std::disjunction<IsPolynomialExpression<L>, IsPolynomialExpression<R>,
+                                        std::negation<std::is_lvalue_reference<L> >,
+                                        std::negation<std::is_lvalue_reference<R> > > > {};
+
+template<class T>
+const Polynomial<T>& Materialize(const Polynomial<T>& polynomial) {
+    return polynomial;
+}
+
+template<class T>
+Polynomial<T>&& Materialize(Polynomial<T>&& polynomial) {
+    return std::move(polynomial);
+}
+
+template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+Polynomial<typename CoefficientOf<E>::type> Materialize(E&& expression) {
+    return Polynomial<typename CoefficientOf<E>::type>(std::forward<E>(expression));
+}
+
+template<class L, class R, class = typename std::enable_if<IsLazySum<L, R>::value>::type>
+SumExpression<typename CoefficientOf<L>::type, typename ExpressionOperand<L>::type,
+              typename ExpressionOperand<R>::type, false>
+operator +(L&& lhs, R&& rhs) {
+    return {MakeOperand(std::forward<L>(lhs)), MakeOperand(std::forward<R>(rhs))};
+}
+
+template<class L, class R, class = typename std::enable_if<IsLazySum<L, R>::value>::type>
+SumExpression<typename CoefficientOf<L>::type, typename ExpressionOperand<L>::type,
+              typename ExpressionOperand<R>::type, true>
+operator -(L&& lhs, R&& rhs) {
+    return {MakeOperand(std::forward<L>(lhs)), MakeOperand(std::forward<R>(rhs))};
+}
+
+template<class E, class = typename std::enable_if<IsPolynomialOperand<E>::value>::type>
+ScaledExpression<typename CoefficientOf<E>::type, typename ExpressionOperand<E>::type>
+operator *(E&& expression, const typename CoefficientOf<E>::type& factor) {
+    return {MakeOperand(std::forward<E>(expression)), factor};
+}
+
+template<class E, class = typename std::enable_if<IsPolynomialOperand<E>::value>::type>
+ScaledExpression<typename CoefficientOf<E>::type, typename ExpressionOperand<E>::type>
+operator *(const typename CoefficientOf<E>::type& factor, E&& expression) {
+    return {MakeOperand(std::forward<E>(expression)), factor};
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+Polynomial<typename CoefficientOf<L>::type> operator *(L&& lhs, R&& rhs) {
+    return Materialize(std::forward<L>(lhs)) * Materialize(std::forward<R>(rhs));
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+Polynomial<typename CoefficientOf<L>::type> operator /(L&& lhs, R&& rhs) {
+    return Materialize(std::forward<L>(lhs)) / Materialize(std::forward<R>(rhs));
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+Polynomial<typename CoefficientOf<L>::type> operator %(L&& lhs, R&& rhs) {
+    return Materialize(std::forward<L>(lhs)) % Materialize(std::forward<R>(rhs));
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+Polynomial<typename CoefficientOf<L>::type> operator ,(L&& lhs, R&& rhs) {
+    return (Materialize(std::forward<L>(lhs)), Materialize(std::forward<R>(rhs)));
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+bool operator ==(const L& lhs, const R& rhs) {
+    return Materialize(lhs) == Materialize(rhs);
+}
+
+template<class L, class R, class = typename std::enable_if<HasExpressionOperand<L, R>::value>::type>
+bool operator !=(const L& lhs, const R& rhs) {
+    return Materialize(lhs) != Materialize(rhs);
+}
+
+template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+std::ostream& operator <<(std::ostream& stream, const E& expression) {
+    return stream << Materialize(expression);
+}
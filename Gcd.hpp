@@ -0,0 +1,347 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "Arena.hpp"
+#include "Multiplication.hpp"
+#include "Division.hpp"
+#include "Stats.hpp"
+
+using std::vector;
+
+
+struct GcdThresholds {
+    static inline size_t half_gcd = 256;
+};
+
+template<class T>
+void TrimCoefficients(ArenaVector<T>& coefficients) {
+    CountStat(StatCounter::Normalizations);
+    while (coefficients.size() > 1 && coefficients.back() == T()) {
+        coefficients.pop_back();
+        CountStat(StatCounter::TrimmedCoefficients);
+    }
+}
+
+template<class T>
+bool IsZeroCoefficients(const ArenaVector<T>& coefficients) {
+    return coefficients.size() == 1 && coefficients[0] == T();
+}
+
+template<class T>
+int GcdDegree(const ArenaVector<T>& coefficients) {
+    return IsZeroCoefficients(coefficients) ? -1 : static_cast<int>(coefficients.size()) - 1;
+}
+
+template<class T>
+ArenaVector<T> MultiplyPolynomials(const ArenaVector<T>& lhs, const ArenaVector<T>& rhs) {
+    ArenaVector<T> product(lhs.size() + rhs.size() - 1);
+    MultiplyCoefficients(&lhs[0], lhs.size(), &rhs[0], rhs.size(), &product[0]);
+    TrimCoefficients(product);
+    return product;
+}
+
+template<class T>
+void AddPolynomials(ArenaVector<T>& lhs, const ArenaVector<T>& rhs, bool subtract) {
+    if (lhs.size() < rhs.size()) {
+        lhs.resize(rhs.size());
+    }
+    for (size_t index = 0; index < rhs.size(); ++index) {
+        if (subtract) {
+            lhs[index] -= rhs[index];
+        } else {
+            lhs[index] += rhs[index];
+        }
+    }
+    TrimCoefficients(lhs);
+}
+
+template<class T>
+ArenaVector<T> ShiftDownPolynomial(const ArenaVector<T>& coefficients, size_t shift) {
+    if (shift >= coefficients.size()) {
+        return ArenaVector<T>(1);
+    }
+    return ArenaVector<T>(coefficients.begin() + shift, coefficients.end());
+}
+
+template<class T>
+void DivModPolynomials(ArenaVector<T>& remainder, const ArenaVector<T>& divisor, ArenaVector<T>& quotient) {
+    if (remainder.size() < divisor.size()) {
+        quotient.assign(1, T());
+        return;
+    }
+    quotient.resize(remainder.size() - divisor.size() + 1);
+    size_t remainder_size = DivideCoefficients(&remainder[0], remainder.size(),
+                                               &divisor[0], divisor.size(), &quotient[0]);
+    if (remainder_size == 0) {
+        remainder.assign(1, T());
+    } else {
+        remainder.resize(remainder_size);
+    }
+    TrimCoefficients(remainder);
+    TrimCoefficients(quotient);
+}
+
+template<class T>
+struct GcdMatrix {
+    ArenaVector<T> entries[2][2];
+
+    GcdMatrix() {
+        entries[0][0].assign(1, T(1));
+        entries[0][1].assign(1, T());
+        entries[1][0].assign(1, T());
+        entries[1][1].assign(1, T(1));
+    }
+
+    explicit GcdMatrix(const ArenaVector<T>& quotient) {
+        entries[0][0].assign(1, T());
+        entries[0][1].assign(1, T(1));
+        entries[1][0].assign(1, T(1));
+        entries[1][1].assign(1, T());
+        AddPolynomials(entries[1][1], quotient, true);
+    }
+
+    GcdMatrix operator *(const GcdMatrix& other) const {
+        GcdMatrix product;
+        for (int row = 0; row < 2; ++row) {
+            for (int column = 0; column < 2; ++column) {
+                product.entries[row][column] = MultiplyPolynomials(entries[row][0], other.entries[0][column]);
+                AddPolynomials(product.entries[row][column],
+                               MultiplyPolynomials(entries[row][1], other.entries[1][column]), false);
+            }
+        }
+        return product;
+    }
+
+    void Apply(ArenaVector<T>& first, ArenaVector<T>& second) const {
+        ArenaVector<T> new_first = MultiplyPolynomials(entries[0][0], first);
+        AddPolynomials(new_first, MultiplyPolynomials(entries[0][1], second), false);
+        ArenaVector<T> new_second = MultiplyPolynomials(entries[1][0], first);
+        AddPolynomials(new_second, MultiplyPolynomials(entries[1][1], second), false);
+        first.swap(new_first);
+        second.swap(new_second);
+    }
+};
+
+template<class T>
+bool EuclidStep(ArenaVector<T>& first, ArenaVector<T>& second, GcdMatrix<T>* cofactors) {
+    CountStat(StatCounter::EuclidSteps);
+    ArenaVector<T> quotient;
+    DivModPolynomials(first, second, quotient);
+    first.swap(second);
+    if (cofactors) {
+        for (int column = 0; column < 2; ++column) {
+            ArenaVector<T>& top = cofactors->entries[0][column];
+            ArenaVector<T>& bottom = cofactors->entries[1][column];
+            AddPolynomials(top, MultiplyPolynomials(quotient, bottom), true);
+            top.swap(bottom);
+        }
+    }
+    return second.size() < first.size() || IsZeroCoefficients(second);
+}
+
+// Returns M with (first', second') = M (first, second) and
+// deg second' < ceil(deg first / 2) <= deg first'; requires deg first > deg second.
+template<class T>
+GcdMatrix<T> HalfGcd(const ArenaVector<T>& first, const ArenaVector<T>& second) {
+    CountStat(StatCounter::HalfGcd);
+    int half = (GcdDegree(first) + 1) / 2;
+    if (GcdDegree(second) < half) {
+        return GcdMatrix<T>();
+    }
+
+    if (first.size() < GcdThresholds::half_gcd) {
+        GcdMatrix<T> result;
+        ArenaVector<T> reduced_first(first);
+        ArenaVector<T> reduced_second(second);
+        while (GcdDegree(reduced_second) >= half && EuclidStep(reduced_first, reduced_second, &result)) {
+        }
+        return result;
+    }
+
+    GcdMatrix<T> result = HalfGcd(ShiftDownPolynomial(first, half), ShiftDownPolynomial(second, half));
+    ArenaVector<T> reduced_first(first);
+    ArenaVector<T> reduced_second(second);
+    result.Apply(reduced_first, reduced_second);
+    if (GcdDegree(reduced_second) < half) {
+        return result;
+    }
+
+    ArenaVector<T> quotient;
+    DivModPolynomials(reduced_first, reduced_second, quotient);
+    result = GcdMatrix<T>(quotient) * result;
+    if (GcdDegree(reduced_first) < half) {
+        return result;
+    }
+
+    size_t shift = 2 * half - GcdDegree(reduced_second);
+    GcdMatrix<T> tail = HalfGcd(ShiftDownPolynomial(reduced_second, shift),
+                                ShiftDownPolynomial(reduced_first, shift));
+    return tail * result;
+}
+
+template<class T>
+ArenaVector<T> PolynomialGcd(ArenaVector<T> first, ArenaVector<T> second, GcdMatrix<T>* cofactors = 0) {
+    CountStat(StatCounter::Gcds);
+    while (!IsZeroCoefficients(second)) {
+        if (!CoefficientTraits<T>::is_field || !CoefficientTraits<T>::is_exact
+            || second.size() < GcdThresholds::half_gcd
+            || first.size() <= second.size()) {
+            if (!EuclidStep(first, second, cofactors)) {
+                break;
+            }
+            continue;
+        }
+
+        GcdMatrix<T> reduction = HalfGcd(first, second);
+        reduction.Apply(first, second);
+        if (cofactors) {
+            *cofactors = reduction * *cofactors;
+        }
+        if (!IsZeroCoefficients(second)) {
+            EuclidStep(first, second, cofactors);
+        }
+    }
+    return first;
+}
+
+template<class T>
+T AbsoluteValue(const T& value) {
+    return value < T() ? T() - value : value;
+}
+
+template<class T>
+T CoefficientGcd(T lhs, T rhs) {
+    lhs = AbsoluteValue(lhs);
+    rhs = AbsoluteValue(rhs);
+    while (rhs != T()) {
+        T rest = lhs % rhs;
+        lhs = rhs;
+        rhs = rest;
+    }
+    return lhs;
+}
+
+// Divides out the gcd of the coefficients.
+template<class T>
+void MakePrimitive(ArenaVector<T>& coefficients) {
+    T content = T();
+    for (size_t index = 0; index < coefficients.size() && content != T(1); ++index) {
+        content = CoefficientGcd(content, coefficients[index]);
+    }
+    if (content != T() && content != T(1)) {
+        for (size_t index = 0; index < coefficients.size(); ++index) {
+            coefficients[index] /= content;
+        }
+    }
+}
+
+// Remainder of lead(divisor)^k dividend by divisor, kept primitive on the way.
+template<class T>
+ArenaVector<T> PseudoRemainder(ArenaVector<T> dividend, const ArenaVector<T>& divisor) {
+    const T& lead = divisor.back();
+    while (dividend.size() >= divisor.size() && !IsZeroCoefficients(dividend)) {
+        T factor = dividend.back();
+        size_t shift = dividend.size() - divisor.size();
+        for (size_t index = 0; index < dividend.size(); ++index) {
+            dividend[index] *= lead;
+        }
+        for (size_t index = 0; index < divisor.size(); ++index) {
+            dividend[shift + index] -= factor * divisor[index];
+        }
+        dividend.pop_back();
+        if (dividend.empty()) {
+            dividend.assign(1, T());
+        }
+        TrimCoefficients(dividend);
+        MakePrimitive(dividend);
+    }
+    return dividend;
+}
+
+// Primitive polynomial remainder sequence; the gcd is defined up to its sign.
+template<class T>
+ArenaVector<T> PrimitiveGcd(ArenaVector<T> first, ArenaVector<T> second) {
+    MakePrimitive(first);
+    MakePrimitive(second);
+    if (first.size() < second.size()) {
+        first.swap(second);
+    }
+    while (!IsZeroCoefficients(second)) {
+        ArenaVector<T> remainder = PseudoRemainder(first, second);
+        first.swap(second);
+        second.swap(remainder);
+    }
+    return first;
+}
+
+// Divides a row (remainder, cofactor of first, cofactor of second) of the
+// extended sequence by the gcd of all its coefficients.
+template<class T>
+void MakePrimitiveRow(ArenaVector<T> (&row)[3]) {
+    T content = T();
+    for (int part = 0; part < 3; ++part) {
+        for (size_t index = 0; index < row[part].size() && content != T(1); ++index) {
+            content = CoefficientGcd(content, row[part][index]);
+        }
+    }
+    if (content != T() && content != T(1)) {
+        for (int part = 0; part < 3; ++part) {
+            for (size_t index = 0; index < row[part].size(); ++index) {
+                row[part][index] /= content;
+            }
+        }
+    }
+}
+
+// Extended remainder sequence without coefficient division: every row keeps
+// remainder = s first + t second and is reduced like PseudoRemainder, except
+// that the content is taken over the whole row. The result is c g for the
+// primitive gcd g and a positive integer c the contents could not remove,
+// with leading coefficient positive and s, t in cofactors.entries[0].
+template<class T>
+ArenaVector<T> PrimitiveGcdEx(const ArenaVector<T>& first, const ArenaVector<T>& second, GcdMatrix<T>& cofactors) {
+    CountStat(StatCounter::Gcds);
+    ArenaVector<T> rows[2][3] = {{first, ArenaVector<T>(1, T(1)), ArenaVector<T>(1, T())},
+                                 {second, ArenaVector<T>(1, T()), ArenaVector<T>(1, T(1))}};
+    if (rows[0][0].size() < rows[1][0].size()) {
+        std::swap(rows[0], rows[1]);
+    }
+    while (!IsZeroCoefficients(rows[1][0])) {
+        ArenaVector<T> (&current)[3] = rows[0];
+        const ArenaVector<T> (&divisor)[3] = rows[1];
+        T lead = divisor[0].back();
+        while (current[0].size() >= divisor[0].size() && !IsZeroCoefficients(current[0])) {
+            CountStat(StatCounter::EuclidSteps);
+            T factor = current[0].back();
+            size_t shift = current[0].size() - divisor[0].size();
+            for (int part = 0; part < 3; ++part) {
+                ArenaVector<T>& target = current[part];
+                if (target.size() < divisor[part].size() + shift) {
+                    target.resize(divisor[part].size() + shift);
+                }
+                for (size_t index = 0; index < target.size(); ++index) {
+                    target[index] *= lead;
+                }
+                for (size_t index = 0; index < divisor[part].size(); ++index) {
+                    target[shift + index] -= factor * divisor[part][index];
+                }
+                TrimCoefficients(target);
+            }
+            MakePrimitiveRow(current);
+        }
+        std::swap(rows[0], rows[1]);
+    }
+
+    if (rows[0][0].back() < T()) {
+        for (int part = 0; part < 3; ++part) {
+            for (size_t index = 0; index < rows[0][part].size(); ++index) {
+                rows[0][part][index] = T() - rows[0][part][index];
+            }
+        }
+    }
+    cofactors.entries[0][0].swap(rows[0][1]);
+    cofactors.entries[0][1].swap(rows[0][2]);
+    return rows[0][0];
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Arena.hpp"
+#include "CoefficientTraits.h"
+#include "Multiplication.hpp"
+#include "Evaluation.hpp"
+
+using std::vector;
+
+
+struct InterpolationThresholds {
+    static inline size_t subproduct_tree = 128;
+};
+
+// Adds weights[i] * product / (x - points[i]) over [begin, end) to result,
+// dividing the monic product of degree end - begin synthetically.
+template<class T>
+void AddLagrangeBasis(const T* points, const T* weights, size_t begin, size_t end, const T* product, T* result) {
+    size_t count = end - begin;
+    for (size_t index = begin; index < end; ++index) {
+        T quotient = product[count];
+        for (size_t power = count; power-- > 0;) {
+            result[power] += weights[index] * quotient;
+            quotient = product[power] + points[index] * quotient;
+        }
+    }
+}
+
+// Barycentric form: weights values[i] / prod (points[i] - points[j]) cost one
+// division per point, and the sum of weights[i] M / (x - points[i]) with
+// M = prod (x - points[j]) needs O(n^2) multiplications.
+template<class T>
+void LagrangeInterpolate(const T* points, const T* values, size_t count, T* coefficients) {
+    ArenaVector<T> product(1, T(1));
+    ArenaVector<T> weights(count);
+    for (size_t index = 0; index < count; ++index) {
+        product.push_back(T(1));
+        for (size_t power = product.size() - 2; power > 0; --power) {
+            product[power] = product[power - 1] - points[index] * product[power];
+        }
+        product[0] = T() - points[index] * product[0];
+
+        T denominator = T(1);
+        for (size_t other = 0; other < count; ++other) {
+            if (other != index) {
+                denominator *= points[index] - points[other];
+            }
+        }
+        if (denominator == T()) {
+            throw std::invalid_argument("Interpolation points must be distinct");
+        }
+        weights[index] = values[index] / denominator;
+    }
+
+    std::fill(coefficients, coefficients + count, T());
+    AddLagrangeBasis(points, &weights[0], 0, count, &product[0], coefficients);
+}
+
+// Sum of weights[i] * node / (x - points[i]) over the points of the node,
+// built from the children as left * right_node + right * left_node.
+template<class T>
+void CombineSubproductTree(const T* points, const T* weights, size_t begin, size_t end, size_t node,
+                           const ArenaVector<ArenaVector<T> >& tree, ArenaVector<T>& result) {
+    size_t count = end - begin;
+    result.assign(count, T());
+    if (count <= EvaluationThresholds::tree_leaf) {
+        AddLagrangeBasis(points, weights, begin, end, &tree[node][0], &result[0]);
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    ArenaVector<T> left;
+    ArenaVector<T> right;
+    CombineSubproductTree(points, weights, begin, middle, 2 * node, tree, left);
+    CombineSubproductTree(points, weights, middle, end, 2 * node + 1, tree, right);
+    const ArenaVector<T>& left_node = tree[2 * node];
+    const ArenaVector<T>& right_node = tree[2 * node + 1];
+    MultiplyCoefficients(&left[0], left.size(), &right_node[0], right_node.size(), &result[0]);
+    ArenaVector<T> product(count);
+    MultiplyCoefficients(&right[0], right.size(), &left_node[0], left_node.size(), &product[0]);
+    for (size_t index = 0; index < count; ++index) {
+        result[index] += product[index];
+    }
+}
+
+// Lagrange interpolation on the subproduct tree of the points: the weights
+// values[i] / M'(points[i]) come from multipoint evaluation of the derivative
+// of the root M, and the sum of weights[i] M / (x - points[i]) is assembled
+// back up the same tree; O(M(n) log n) operations.
+template<class T>
+void SubproductTreeInterpolate(const T* points, const T* values, size_t count, T* coefficients) {
+    ArenaVector<ArenaVector<T> > tree(4 * (count / EvaluationThresholds::tree_leaf + 1));
+    BuildSubproductTree(points, 0, count, 1, tree);
+
+    const ArenaVector<T>& root = tree[1];
+    ArenaVector<T> derivative(count);
+    for (size_t power = 1; power <= count; ++power) {
+        derivative[power - 1] = root[power] * T(static_cast<int>(power));
+    }
+    ArenaVector<T> weights(count);
+    ArenaVector<T> scratch;
+    DescendSubproductTree(std::move(derivative), points, 0, count, 1, tree, &weights[0], scratch);
+    for (size_t index = 0; index < count; ++index) {
+        if (weights[index] == T()) {
+            throw std::invalid_argument("Interpolation points must be distinct");
+        }
+        weights[index] = values[index] / weights[index];
+    }
+
+    ArenaVector<T> result;
+    CombineSubproductTree(points, &weights[0], 0, count, 1, tree, result);
+    std::copy(result.begin(), result.end(), coefficients);
+}
+
+// The subproduct tree needs exact arithmetic, as in multipoint evaluation;
+// floating point samples always take the quadratic path.
+template<class T>
+void InterpolateCoefficients(const T* points, const T* values, size_t count, T* coefficients) {
+    static_assert(CoefficientTraits<T>::is_field, "interpolation divides coefficients");
+    if constexpr (CoefficientTraits<T>::is_exact) {
+        if (count >= std::max(InterpolationThresholds::subproduct_tree, EvaluationThresholds::tree_leaf + 1)) {
+            SubproductTreeInterpolate(points, values, count, coefficients);
+            return;
+        }
+    }
+    LagrangeInterpolate(points, values, count, coefficients);
+}
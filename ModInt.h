@@ -0,0 +1,194 @@
+#pragma once
+#include <iostream>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "CoefficientTraits.h"
+
+
+// Residue modulo a prime Modulus kept in Montgomery form (value * 2^32 mod
+// Modulus), so a product needs two multiplications and a shift instead of a
+// 64-bit division. Moduli stay below 2^30: a sum of sixteen raw products then
+// still fits into 64 bits, which the multiplication kernels use to delay the
+// reduction.
+template<unsigned Modulus>
+class ModInt {
+    static_assert(Modulus % 2 == 1 && Modulus > 2, "Montgomery reduction needs an odd modulus");
+    static_assert(Modulus < (1u << 30), "lazy reduction needs a modulus below 2^30");
+
+private:
+    unsigned raw;
+
+    static constexpr unsigned NegatedInverse() {
+        unsigned inverse = Modulus;
+        for (int step = 0; step < 5; ++step) {
+            inverse *= 2u - Modulus * inverse;
+        }
+        return 0u - inverse;
+    }
+
+    static constexpr unsigned kNegatedInverse = NegatedInverse();
+    static constexpr unsigned kSquaredRadix =
+        static_cast<unsigned>((1ULL << 32) % Modulus * ((1ULL << 32) % Modulus) % Modulus);
+
+public:
+    typedef unsigned long long Wide;
+
+    static constexpr unsigned modulus = Modulus;
+
+    // Montgomery reduction: returns value / 2^32 mod Modulus for any value
+    // below Modulus * 2^32.
+    static constexpr unsigned Reduce(Wide value) {
+        unsigned factor = static_cast<unsigned>(value) * kNegatedInverse;
+        unsigned result = static_cast<unsigned>((value + static_cast<Wide>(factor) * Modulus) >> 32);
+        return result >= Modulus ? result - Modulus : result;
+    }
+
+    static constexpr ModInt FromRaw(unsigned raw) {
+        ModInt result;
+        result.raw = raw;
+        return result;
+    }
+
+    constexpr ModInt(long long value = 0) : raw(0) {
+        long long residue = value % static_cast<long long>(Modulus);
+        if (residue < 0) {
+            residue += Modulus;
+        }
+        raw = Reduce(static_cast<Wide>(residue) * kSquaredRadix);
+    }
+
+    constexpr unsigned Raw() const {
+        return raw;
+    }
+
+    constexpr unsigned Value() const {
+        return Reduce(raw);
+    }
+
+    constexpr ModInt Power(unsigned long long exponent) const {
+        ModInt result(1);
+        ModInt base = *this;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result *= base;
+            }
+            base *= base;
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    constexpr ModInt Inverse() const {
+        if (raw == 0) {
+            throw std::overflow_error("Divide by zero");
+        }
+        return Power(Modulus - 2);
+    }
+
+    constexpr ModInt& operator +=(const ModInt& other) {
+        raw += other.raw;
+        if (raw >= Modulus) {
+            raw -= Modulus;
+        }
+        return *this;
+    }
+
+    constexpr ModInt& operator -=(const ModInt& other) {
+        raw = raw >= other.raw ? raw - other.raw : raw + Modulus - other.raw;
+        return *this;
+    }
+
+    constexpr ModInt& operator *=(const ModInt& other) {
+        raw = Reduce(static_cast<Wide>(raw) * other.raw);
+        return *this;
+    }
+
+    constexpr ModInt& operator /=(const ModInt& other) {
+        return *this *= other.Inverse();
+    }
+
+    constexpr ModInt operator -() const {
+        return FromRaw(raw == 0 ? 0 : Modulus - raw);
+    }
+
+    friend constexpr ModInt operator +(ModInt lhs, const ModInt& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend constexpr ModInt operator -(ModInt lhs, const ModInt& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend constexpr ModInt operator *(ModInt lhs, const ModInt& rhs)
+    {
+        return lhs *= rhs;
+    }
+
+    friend constexpr ModInt operator /(ModInt lhs, const ModInt& rhs)
+    {
+        return lhs /= rhs;
+    }
+
+    friend constexpr bool operator ==(const ModInt& lhs, const ModInt& rhs)
+    {
+        return lhs.raw == rhs.raw;
+    }
+
+    friend constexpr bool operator !=(const ModInt& lhs, const ModInt& rhs)
+    {
+        return lhs.raw != rhs.raw;
+    }
+
+    // Orders residues by their canonical value; only used to order
+    // polynomials of equal degree.
+    friend constexpr bool operator <(const ModInt& lhs, const ModInt& rhs)
+    {
+        return lhs.Value() < rhs.Value();
+    }
+
+    friend std::ostream& operator <<(std::ostream& stream, const ModInt& value)
+    {
+        return stream << value.Value();
+    }
+};
+
+template<class T>
+struct IsModInt : std::false_type {};
+
+template<unsigned Modulus>
+struct IsModInt<ModInt<Modulus> > : std::true_type {};
+
+template<unsigned Modulus>
+struct CoefficientTraits<ModInt<Modulus> > {
+    static const bool is_field = true;
+    static const bool is_exact = true;
+};
+
+// Residues have no sign, so every monomial after the first is joined by " + "
+// and printed with its canonical value.
+template<unsigned Modulus>
+void AddMonomial(ModInt<Modulus> coef, int degree, std::ostream& stream, bool isFirst) {
+    if (coef == ModInt<Modulus>()) {
+        if (degree == 0 && isFirst) {
+            stream << coef;
+        }
+        return;
+    }
+
+    if (!isFirst) {
+        stream << " + ";
+    }
+    if (degree == 0 || coef != ModInt<Modulus>(1)) {
+        stream << coef;
+    }
+    if (degree != 0) {
+        stream << "x";
+        if (degree != 1) {
+            stream << "^" << degree;
+        }
+    }
+}
@@ -0,0 +1,367 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "Arena.hpp"
+#include "BigInt.h"
+#include "Division.hpp"
+#include "Gcd.hpp"
+#include "Multiplication.hpp"
+#include "Stats.hpp"
+#include "ThreadPool.hpp"
+#include "Transform.hpp"
+
+using std::vector;
+
+
+struct MultiModularThresholds {
+    static inline size_t parallel_primes = 4;
+};
+
+// Deterministic Miller-Rabin for numbers below 2^32 with the bases 2, 7, 61.
+inline bool IsPrime32(unsigned long long value) {
+    if (value < 2 || value % 2 == 0) {
+        return value == 2;
+    }
+    unsigned long long odd = value - 1;
+    int twos = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++twos;
+    }
+    for (unsigned long long base : {2ULL, 7ULL, 61ULL}) {
+        if (base % value == 0) {
+            continue;
+        }
+        unsigned long long power = PowerMod(base, odd, value);
+        bool witness = power != 1 && power != value - 1;
+        for (int step = 1; step < twos && witness; ++step) {
+            power = power * power % value;
+            witness = power != value - 1;
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Primes c 2^20 + 1 below 2^31, largest first: each allows transforms of up to
+// 2^20 points, and the sum of two residues still fits into 32 bits as
+// NumberTheoreticTransform needs. Found once, on first use.
+inline const vector<NttPrime>& MultiModularPrimes() {
+    static const vector<NttPrime> primes = [] {
+        vector<NttPrime> found;
+        for (unsigned long long factor = (1ULL << 11) - 1; factor > 0; --factor) {
+            unsigned long long candidate = (factor << 20) + 1;
+            if (IsPrime32(candidate)) {
+                unsigned max_log_size = 20;
+                while ((factor >> (max_log_size - 20)) % 2 == 0) {
+                    ++max_log_size;
+                }
+                found.push_back(NttPrime{static_cast<unsigned>(candidate),
+                                         static_cast<unsigned>(PrimitiveRoot(candidate)), max_log_size});
+            }
+        }
+        return found;
+    }();
+    return primes;
+}
+
+// Number of leading primes of MultiModularPrimes whose product exceeds 2^bits,
+// or zero when the whole table is not enough.
+inline size_t MultiModularPrimesNeeded(size_t bits) {
+    const vector<NttPrime>& primes = MultiModularPrimes();
+    size_t available = 0;
+    for (size_t count = 0; count < primes.size(); ++count) {
+        available += BitLength(primes[count].modulus) - 1;
+        if (available > bits) {
+            return count + 1;
+        }
+    }
+    return 0;
+}
+
+// Runs function(index) for index < count, on the shared ThreadPool when count
+// is the number of primes and there are enough of them to pay for the tasks.
+template<class Function>
+void MultiModularFor(size_t count, const Function& function) {
+    if (count >= MultiModularThresholds::parallel_primes) {
+        ThreadPool::Shared().ParallelFor(count, function);
+        return;
+    }
+    for (size_t index = 0; index < count; ++index) {
+        function(index);
+    }
+}
+
+// Garner's digits with the moduli of a product, turned into a BigInt in the
+// symmetric range around zero.
+struct CrtBasis {
+    GarnerBasis garner;
+    BigInt product;
+    BigInt half;
+
+    explicit CrtBasis(const ArenaVector<unsigned long long>& moduli) : garner(moduli) {
+        product = BigInt(1);
+        for (size_t count = 0; count < moduli.size(); ++count) {
+            product.MultiplyAdd(static_cast<unsigned>(moduli[count]), 0);
+        }
+        half = product / BigInt(2);
+    }
+
+    // Integer with residues[count][index] modulo moduli[count].
+    template<class Residues>
+    BigInt Reconstruct(const Residues& residues, size_t index) const {
+        const ArenaVector<unsigned long long>& moduli = garner.moduli;
+        ArenaVector<unsigned long long> digits(moduli.size());
+        garner.Digits(residues, index, &digits[0]);
+
+        BigInt value;
+        for (size_t count = moduli.size(); count-- > 0;) {
+            value.MultiplyAdd(static_cast<unsigned>(moduli[count]), static_cast<unsigned>(digits[count]));
+        }
+        if (value > half) {
+            value -= product;
+        }
+        return value;
+    }
+};
+
+// Product modulo enough transform primes that the symmetric range covers
+// min(lhs_size, rhs_size) * max |lhs| * max |rhs|; the primes are independent
+// and run in parallel, and so does the reconstruction of the coefficients.
+inline bool MultiModularMultiply(const BigInt* lhs, size_t lhs_size, const BigInt* rhs, size_t rhs_size, BigInt* out) {
+    size_t product_size = lhs_size + rhs_size - 1;
+    size_t size = TransformSize(product_size);
+    size_t lhs_bits = 0;
+    size_t rhs_bits = 0;
+    for (size_t index = 0; index < lhs_size; ++index) {
+        lhs_bits = std::max(lhs_bits, lhs[index].BitLength());
+    }
+    for (size_t index = 0; index < rhs_size; ++index) {
+        rhs_bits = std::max(rhs_bits, rhs[index].BitLength());
+    }
+    size_t primes = MultiModularPrimesNeeded(lhs_bits + rhs_bits + BitLength(std::min(lhs_size, rhs_size)) + 1);
+    if (primes == 0 || size > (size_t(1) << 20)) {
+        return false;
+    }
+
+    // Sized here: a worker must not grow memory taken from this thread's arena.
+    const vector<NttPrime>& table = MultiModularPrimes();
+    ArenaVector<ArenaVector<unsigned> > residues(primes);
+    ArenaVector<unsigned long long> moduli(primes);
+    for (size_t count = 0; count < primes; ++count) {
+        residues[count].assign(size, 0);
+        moduli[count] = table[count].modulus;
+    }
+    MultiModularFor(primes, [&](size_t count) {
+        const NttPrime& prime = table[count];
+        ArenaVector<unsigned> lhs_values(size);
+        ArenaVector<unsigned>& rhs_values = residues[count];
+        for (size_t index = 0; index < lhs_size; ++index) {
+            lhs_values[index] = lhs[index].Modulo(prime.modulus);
+        }
+        for (size_t index = 0; index < rhs_size; ++index) {
+            rhs_values[index] = rhs[index].Modulo(prime.modulus);
+        }
+        NumberTheoreticTransform(lhs_values, prime, false);
+        NumberTheoreticTransform(rhs_values, prime, false);
+        for (size_t index = 0; index < size; ++index) {
+            rhs_values[index] = static_cast<unsigned>(lhs_values[index] * 1ULL * rhs_values[index] % prime.modulus);
+        }
+        NumberTheoreticTransform(rhs_values, prime, true);
+    });
+
+    CrtBasis basis(moduli);
+    size_t blocks = std::min(primes, product_size);
+    MultiModularFor(blocks, [&](size_t block) {
+        for (size_t index = block; index < product_size; index += blocks) {
+            out[index] = basis.Reconstruct(residues, index);
+        }
+    });
+    return true;
+}
+
+// Euclid modulo a prime on residue vectors without trailing zeros, where the
+// zero polynomial is empty; leaves the monic gcd in first.
+inline void ModularPolynomialGcd(ArenaVector<unsigned long long>& first, ArenaVector<unsigned long long>& second,
+                                 unsigned long long modulus) {
+    while (!second.empty()) {
+        unsigned long long inverse = ModularInverse(second.back(), modulus);
+        while (first.size() >= second.size()) {
+            unsigned long long factor = first.back() * inverse % modulus;
+            size_t shift = first.size() - second.size();
+            for (size_t index = 0; index < second.size(); ++index) {
+                first[shift + index] = (first[shift + index] + modulus - factor * second[index] % modulus) % modulus;
+            }
+            while (!first.empty() && first.back() == 0) {
+                first.pop_back();
+            }
+        }
+        first.swap(second);
+    }
+    if (!first.empty()) {
+        unsigned long long inverse = ModularInverse(first.back(), modulus);
+        for (size_t index = 0; index < first.size(); ++index) {
+            first[index] = first[index] * inverse % modulus;
+        }
+    }
+}
+
+inline bool DividesExactly(const ArenaVector<BigInt>& dividend, const ArenaVector<BigInt>& divisor) {
+    if (dividend.size() < divisor.size()) {
+        return IsZeroCoefficients(dividend);
+    }
+    ArenaVector<BigInt> remainder(dividend);
+    ArenaVector<BigInt> quotient(dividend.size() - divisor.size() + 1);
+    size_t remainder_size = LongDivide(&remainder[0], remainder.size(), &divisor[0], divisor.size(), &quotient[0]);
+    return std::all_of(remainder.begin(), remainder.begin() + remainder_size, [](const BigInt& coef) {
+        return coef.IsZero();
+    });
+}
+
+// content times a gcd found up to its sign, with a positive leading coefficient.
+inline ArenaVector<BigInt> ScaleGcd(ArenaVector<BigInt> gcd, const BigInt& content) {
+    BigInt scale = gcd.back() < BigInt() ? -content : content;
+    for (BigInt& coef : gcd) {
+        coef *= scale;
+    }
+    return gcd;
+}
+
+// Gcd of integer polynomials from its images modulo word-sized primes. With
+// both inputs primitive, the gcd scaled to leading coefficient
+// g = gcd(lead(first), lead(second)) is g times the monic gcd modulo every
+// prime that divides neither leading coefficient, except for the finitely many
+// unlucky primes whose image has a higher degree; only images of the lowest
+// degree seen are kept. Its coefficients are below g 2^d min(|first|, |second|)
+// for d the smaller degree (Landau-Mignotte), which decides how many primes
+// the Chinese remaindering needs; the result is checked by trial division and
+// more primes are added if it fails. The gcd is returned with the gcd of the
+// contents and a positive leading coefficient.
+inline ArenaVector<BigInt> MultiModularGcd(ArenaVector<BigInt> first, ArenaVector<BigInt> second) {
+    CountStat(StatCounter::ModularGcd);
+    TrimCoefficients(first);
+    TrimCoefficients(second);
+    if (IsZeroCoefficients(first)) {
+        first.swap(second);
+    }
+    if (IsZeroCoefficients(second)) {
+        return ScaleGcd(std::move(first), BigInt(1));
+    }
+
+    BigInt first_content;
+    BigInt second_content;
+    for (const BigInt& coef : first) {
+        first_content = CoefficientGcd(first_content, coef);
+    }
+    for (const BigInt& coef : second) {
+        second_content = CoefficientGcd(second_content, coef);
+    }
+    for (BigInt& coef : first) {
+        coef /= first_content;
+    }
+    for (BigInt& coef : second) {
+        coef /= second_content;
+    }
+    BigInt content = CoefficientGcd(first_content, second_content);
+    if (first.size() == 1 || second.size() == 1) {
+        return ArenaVector<BigInt>(1, content);
+    }
+
+    BigInt lead = CoefficientGcd(first.back(), second.back());
+    auto norm_bits = [](const ArenaVector<BigInt>& coefficients) {
+        size_t bits = 0;
+        for (const BigInt& coef : coefficients) {
+            bits = std::max(bits, coef.BitLength());
+        }
+        return bits + BitLength(coefficients.size());
+    };
+    size_t bits = lead.BitLength() + std::min(first.size(), second.size()) - 1
+        + std::min(norm_bits(first), norm_bits(second)) + 1;
+
+    const vector<NttPrime>& table = MultiModularPrimes();
+    size_t needed = MultiModularPrimesNeeded(bits);
+    if (needed == 0) {
+        return ScaleGcd(PrimitiveGcd(first, second), content);
+    }
+
+    ArenaVector<unsigned long long> moduli;
+    ArenaVector<ArenaVector<unsigned long long> > images;
+    size_t gcd_size = first.size();
+    size_t next = 0;
+    while (next < table.size()) {
+        size_t batch = std::min(std::max(needed, moduli.size() + 1) - moduli.size(), table.size() - next);
+        ArenaVector<ArenaVector<unsigned long long> > batch_images(batch);
+        MultiModularFor(batch, [&](size_t count) {
+            unsigned long long modulus = table[next + count].modulus;
+            ArenaVector<unsigned long long> first_image(first.size());
+            ArenaVector<unsigned long long> second_image(second.size());
+            for (size_t index = 0; index < first.size(); ++index) {
+                first_image[index] = first[index].Modulo(static_cast<unsigned>(modulus));
+            }
+            for (size_t index = 0; index < second.size(); ++index) {
+                second_image[index] = second[index].Modulo(static_cast<unsigned>(modulus));
+            }
+            if (first_image.back() == 0 || second_image.back() == 0) {
+                return;
+            }
+            ModularPolynomialGcd(first_image, second_image, modulus);
+            unsigned long long scale = lead.Modulo(static_cast<unsigned>(modulus));
+            for (unsigned long long& coef : first_image) {
+                coef = coef * scale % modulus;
+            }
+            batch_images[count].swap(first_image);
+        });
+
+        for (size_t count = 0; count < batch; ++count) {
+            ArenaVector<unsigned long long>& image = batch_images[count];
+            if (image.empty() || image.size() > gcd_size) {
+                continue;
+            }
+            if (image.size() < gcd_size) {
+                gcd_size = image.size();
+                moduli.clear();
+                images.clear();
+            }
+            moduli.push_back(table[next + count].modulus);
+            images.emplace_back();
+            images.back().swap(image);
+        }
+        next += batch;
+        if (gcd_size == 1) {
+            return ArenaVector<BigInt>(1, content);
+        }
+        if (moduli.size() < needed) {
+            continue;
+        }
+
+        CrtBasis basis(moduli);
+        ArenaVector<BigInt> gcd(gcd_size);
+        for (size_t index = 0; index < gcd_size; ++index) {
+            gcd[index] = basis.Reconstruct(images, index);
+        }
+        MakePrimitive(gcd);
+        if (DividesExactly(first, gcd) && DividesExactly(second, gcd)) {
+            return ScaleGcd(std::move(gcd), content);
+        }
+    }
+
+    return ScaleGcd(PrimitiveGcd(first, second), content);
+}
+
+inline bool CoefficientAlgorithms<BigInt>::Multiply(const BigInt* lhs, size_t lhs_size, const BigInt* rhs, size_t rhs_size,
+                                                    BigInt* out) {
+    if (std::min(lhs_size, rhs_size) < MultiplicationThresholds::multi_modular
+        || !MultiModularMultiply(lhs, lhs_size, rhs, rhs_size, out)) {
+        return false;
+    }
+    CountStat(StatCounter::MultiModular);
+    return true;
+}
+
+inline ArenaVector<BigInt> CoefficientAlgorithms<BigInt>::Gcd(ArenaVector<BigInt> first, ArenaVector<BigInt> second) {
+    return MultiModularGcd(std::move(first), std::move(second));
+}
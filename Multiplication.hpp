@@ -0,0 +1,342 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "Arena.hpp"
+#include "Stats.hpp"
+#include "CoefficientTraits.h"
+#include "ModInt.h"
+#include "Transform.hpp"
+
+using std::vector;
+
+
+struct MultiplicationThresholds {
+    static inline size_t karatsuba = 32;
+    static inline size_t toom3 = 200;
+    static inline size_t fft = 1500;
+    static inline size_t ntt = 6000;
+    static inline size_t modular_ntt = 128;
+    static inline size_t multi_modular = 64;
+};
+
+template<class T, bool = std::is_integral<T>::value>
+struct MultiplicationRing {
+    typedef T type;
+    static const bool toom3 = CoefficientTraits<T>::is_field;
+};
+
+// Toom-3 interpolation divides by 3, which modulo 3 is zero; Karatsuba only
+// needs the ring operations.
+template<unsigned Modulus>
+struct MultiplicationRing<ModInt<Modulus>, false> {
+    typedef ModInt<Modulus> type;
+    static const bool toom3 = Modulus % 3 != 0;
+};
+
+template<class T>
+struct MultiplicationRing<T, true> {
+#ifdef __SIZEOF_INT128__
+    typedef typename std::conditional<(sizeof(T) <= 4), unsigned long long, unsigned __int128>::type type;
+    static const bool toom3 = true;
+#else
+    typedef unsigned long long type;
+    static const bool toom3 = sizeof(T) <= 4;
+#endif
+};
+
+template<class R>
+struct IsWrappingRing : std::is_unsigned<R> {};
+
+#ifdef __SIZEOF_INT128__
+template<>
+struct IsWrappingRing<unsigned __int128> : std::true_type {};
+#endif
+
+template<class R>
+R ExactHalf(const R& value) {
+    if constexpr (IsWrappingRing<R>::value) {
+        return value >> 1;
+    } else {
+        return value / R(2);
+    }
+}
+
+template<class R>
+R ExactThird(const R& value) {
+    if constexpr (IsWrappingRing<R>::value) {
+        static const R inverse = [] {
+            R result = 3;
+            for (int step = 0; step < 7; ++step) {
+                result *= R(2) - R(3) * result;
+            }
+            return result;
+        }();
+        return value * inverse;
+    } else {
+        return value / R(3);
+    }
+}
+
+// Sums raw Montgomery products in 64-bit accumulators and reduces them only
+// every kLazyRows rows and once at the end; the reduction is linear, so
+// reducing the sum gives the sum of the reduced products.
+template<unsigned Modulus>
+void LazySchoolbookMultiply(const ModInt<Modulus>* lhs, size_t lhs_size, const ModInt<Modulus>* rhs, size_t rhs_size,
+                            ModInt<Modulus>* out) {
+    typedef unsigned long long Wide;
+    const size_t kLazyRows = 8;
+    const Wide bound = static_cast<Wide>(Modulus) * Modulus * kLazyRows;
+
+    ArenaVector<Wide> sums(lhs_size + rhs_size - 1);
+    for (size_t index = 0; index < lhs_size; ++index) {
+        Wide factor = lhs[index].Raw();
+        Wide* target = &sums[index];
+        for (size_t other_index = 0; other_index < rhs_size; ++other_index) {
+            target[other_index] += factor * rhs[other_index].Raw();
+        }
+        if ((index + 1) % kLazyRows == 0) {
+            for (size_t other_index = index + 1 - kLazyRows; other_index < index + rhs_size; ++other_index) {
+                Wide& sum = sums[other_index];
+                if (sum >= bound) {
+                    sum -= bound;
+                }
+            }
+        }
+    }
+    for (size_t index = 0; index < sums.size(); ++index) {
+        out[index] = ModInt<Modulus>::FromRaw(ModInt<Modulus>::Reduce(sums[index] % Modulus));
+    }
+}
+
+template<class R>
+void SchoolbookMultiply(const R* lhs, size_t lhs_size, const R* rhs, size_t rhs_size, R* out) {
+    if constexpr (std::is_integral<R>::value && std::is_signed<R>::value) {
+        // Wraps modulo 2^W like the Karatsuba ring instead of overflowing.
+        typedef typename std::make_unsigned<R>::type U;
+        SchoolbookMultiply(reinterpret_cast<const U*>(lhs), lhs_size, reinterpret_cast<const U*>(rhs), rhs_size,
+                           reinterpret_cast<U*>(out));
+        return;
+    }
+    CountStat(StatCounter::CoefficientMultiplies, lhs_size * rhs_size);
+    if constexpr (IsModInt<R>::value) {
+        LazySchoolbookMultiply(lhs, lhs_size, rhs, rhs_size, out);
+        return;
+    }
+    std::fill(out, out + lhs_size + rhs_size - 1, R());
+    for (size_t index = 0; index < lhs_size; ++index) {
+        for (size_t other_index = 0; other_index < rhs_size; ++other_index) {
+            out[index + other_index] += lhs[index] * rhs[other_index];
+        }
+    }
+}
+
+template<class R>
+void KaratsubaMultiply(const R* lhs, const R* rhs, size_t size, R* out, R* scratch) {
+    if (size < std::max<size_t>(MultiplicationThresholds::karatsuba, 2)) {
+        SchoolbookMultiply(lhs, size, rhs, size, out);
+        return;
+    }
+
+    size_t low = size / 2;
+    size_t high = size - low;
+
+    KaratsubaMultiply(lhs, rhs, low, out, scratch);
+    out[2 * low - 1] = R();
+    KaratsubaMultiply(lhs + low, rhs + low, high, out + 2 * low, scratch);
+
+    R* lhs_sum = scratch;
+    R* rhs_sum = scratch + high;
+    R* middle = scratch + 2 * high;
+    for (size_t index = 0; index < high; ++index) {
+        lhs_sum[index] = lhs[low + index];
+        rhs_sum[index] = rhs[low + index];
+        if (index < low) {
+            lhs_sum[index] += lhs[index];
+            rhs_sum[index] += rhs[index];
+        }
+    }
+    KaratsubaMultiply(lhs_sum, rhs_sum, high, middle, scratch + 4 * high);
+
+    for (size_t index = 0; index + 1 < 2 * low; ++index) {
+        middle[index] -= out[index];
+    }
+    for (size_t index = 0; index + 1 < 2 * high; ++index) {
+        middle[index] -= out[2 * low + index];
+    }
+    for (size_t index = 0; index + 1 < 2 * high; ++index) {
+        out[low + index] += middle[index];
+    }
+}
+
+template<class R, bool UseToom3>
+void MultiplyBalanced(const R* lhs, const R* rhs, size_t size, R* out);
+
+template<class R, bool UseToom3>
+void Toom3Multiply(const R* lhs, const R* rhs, size_t size, R* out) {
+    size_t part = (size + 2) / 3;
+    size_t top = size - 2 * part;
+    size_t part_product = 2 * part - 1;
+    size_t out_size = 2 * size - 1;
+
+    ArenaVector<R> buffer(6 * part + 3 * part_product);
+    R* lhs_one = &buffer[0];
+    R* lhs_minus_one = lhs_one + part;
+    R* lhs_minus_two = lhs_minus_one + part;
+    R* rhs_one = lhs_minus_two + part;
+    R* rhs_minus_one = rhs_one + part;
+    R* rhs_minus_two = rhs_minus_one + part;
+    R* at_one = rhs_minus_two + part;
+    R* at_minus_one = at_one + part_product;
+    R* at_minus_two = at_minus_one + part_product;
+
+    for (size_t index = 0; index < part; ++index) {
+        R top_lhs = index < top ? lhs[2 * part + index] : R();
+        R top_rhs = index < top ? rhs[2 * part + index] : R();
+        R even_lhs = lhs[index] + top_lhs;
+        R even_rhs = rhs[index] + top_rhs;
+        lhs_one[index] = even_lhs + lhs[part + index];
+        rhs_one[index] = even_rhs + rhs[part + index];
+        lhs_minus_one[index] = even_lhs - lhs[part + index];
+        rhs_minus_one[index] = even_rhs - rhs[part + index];
+        lhs_minus_two[index] = (lhs_minus_one[index] + top_lhs) * R(2) - lhs[index];
+        rhs_minus_two[index] = (rhs_minus_one[index] + top_rhs) * R(2) - rhs[index];
+    }
+
+    MultiplyBalanced<R, UseToom3>(lhs_one, rhs_one, part, at_one);
+    MultiplyBalanced<R, UseToom3>(lhs_minus_one, rhs_minus_one, part, at_minus_one);
+    MultiplyBalanced<R, UseToom3>(lhs_minus_two, rhs_minus_two, part, at_minus_two);
+
+    MultiplyBalanced<R, UseToom3>(lhs, rhs, part, out);
+    std::fill(out + part_product, out + 4 * part, R());
+    MultiplyBalanced<R, UseToom3>(lhs + 2 * part, rhs + 2 * part, top, out + 4 * part);
+
+    for (size_t index = 0; index < part_product; ++index) {
+        R at_zero = out[index];
+        R at_infinity = index + 4 * part < out_size ? out[4 * part + index] : R();
+
+        R third = ExactThird(at_minus_two[index] - at_one[index]);
+        R first = ExactHalf(at_one[index] - at_minus_one[index]);
+        R second = at_minus_one[index] - at_zero;
+        third = ExactHalf(second - third) + at_infinity * R(2);
+        second += first - at_infinity;
+        first -= third;
+
+        at_one[index] = first;
+        at_minus_one[index] = second;
+        at_minus_two[index] = third;
+    }
+
+    for (size_t index = 0; index < part_product; ++index) {
+        out[part + index] += at_one[index];
+        out[2 * part + index] += at_minus_one[index];
+        if (3 * part + index < out_size) {
+            out[3 * part + index] += at_minus_two[index];
+        }
+    }
+}
+
+template<class R, bool UseToom3>
+void MultiplyBalanced(const R* lhs, const R* rhs, size_t size, R* out) {
+    if (UseToom3 && size >= std::max<size_t>(MultiplicationThresholds::toom3, 9)) {
+        Toom3Multiply<R, UseToom3>(lhs, rhs, size, out);
+        return;
+    }
+    if (size < MultiplicationThresholds::karatsuba) {
+        SchoolbookMultiply(lhs, size, rhs, size, out);
+        return;
+    }
+    ArenaVector<R> scratch(4 * size + 64);
+    KaratsubaMultiply(lhs, rhs, size, out, &scratch[0]);
+}
+
+template<class R, bool UseToom3>
+void MultiplyRange(const R* lhs, size_t lhs_size, const R* rhs, size_t rhs_size, R* out) {
+    if (lhs_size < rhs_size) {
+        std::swap(lhs, rhs);
+        std::swap(lhs_size, rhs_size);
+    }
+
+    if (rhs_size < MultiplicationThresholds::karatsuba) {
+        SchoolbookMultiply(lhs, lhs_size, rhs, rhs_size, out);
+        return;
+    }
+
+    if (lhs_size == rhs_size) {
+        MultiplyBalanced<R, UseToom3>(lhs, rhs, lhs_size, out);
+        return;
+    }
+
+    std::fill(out, out + lhs_size + rhs_size - 1, R());
+    ArenaVector<R> chunk_product(2 * rhs_size - 1);
+    for (size_t offset = 0; offset < lhs_size; offset += rhs_size) {
+        size_t chunk = std::min(rhs_size, lhs_size - offset);
+        MultiplyRange<R, UseToom3>(lhs + offset, chunk, rhs, rhs_size, &chunk_product[0]);
+        for (size_t index = 0; index + 1 < chunk + rhs_size; ++index) {
+            out[offset + index] += chunk_product[index];
+        }
+    }
+}
+
+template<class T>
+void MultiplyCoefficients(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out) {
+    size_t min_size = std::min(lhs_size, rhs_size);
+    if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+        if (min_size >= MultiplicationThresholds::fft) {
+            CountStat(StatCounter::Fft);
+            FftMultiply(lhs, lhs_size, rhs, rhs_size, out);
+            return;
+        }
+    } else if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+        if (min_size >= MultiplicationThresholds::ntt && NttMultiply(lhs, lhs_size, rhs, rhs_size, out)) {
+            CountStat(StatCounter::Ntt);
+            return;
+        }
+    } else if constexpr (IsModInt<T>::value) {
+        if (min_size >= MultiplicationThresholds::modular_ntt && ModularNttMultiply(lhs, lhs_size, rhs, rhs_size, out)) {
+            CountStat(StatCounter::ModularNtt);
+            return;
+        }
+    } else if constexpr (CoefficientAlgorithms<T>::has_multiply) {
+        if (CoefficientAlgorithms<T>::Multiply(lhs, lhs_size, rhs, rhs_size, out)) {
+            return;
+        }
+    }
+
+    if (min_size < MultiplicationThresholds::karatsuba) {
+        CountStat(StatCounter::Schoolbook);
+        SchoolbookMultiply(lhs, lhs_size, rhs, rhs_size, out);
+        return;
+    }
+
+    typedef MultiplicationRing<T> Ring;
+    typedef typename Ring::type R;
+
+    // MultiplyRange works on blocks of the shorter length, which decides the
+    // algorithm used at the top of the recursion.
+    if (Ring::toom3 && min_size >= std::max<size_t>(MultiplicationThresholds::toom3, 9)) {
+        CountStat(StatCounter::Toom3);
+    } else {
+        CountStat(StatCounter::Karatsuba);
+    }
+
+    if constexpr (std::is_same<R, T>::value) {
+        MultiplyRange<R, Ring::toom3>(lhs, lhs_size, rhs, rhs_size, out);
+    } else {
+        ArenaVector<R> ring_lhs(lhs_size);
+        ArenaVector<R> ring_rhs(rhs_size);
+        ArenaVector<R> ring_out(lhs_size + rhs_size - 1);
+        for (size_t index = 0; index < lhs_size; ++index) {
+            ring_lhs[index] = static_cast<R>(lhs[index]);
+        }
+        for (size_t index = 0; index < rhs_size; ++index) {
+            ring_rhs[index] = static_cast<R>(rhs[index]);
+        }
+        MultiplyRange<R, Ring::toom3>(&ring_lhs[0], lhs_size, &ring_rhs[0], rhs_size, &ring_out[0]);
+        for (size_t index = 0; index < ring_out.size(); ++index) {
+            out[index] = static_cast<T>(ring_out[index]);
+        }
+    }
+}
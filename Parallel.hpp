@@ -0,0 +1,181 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "Arena.hpp"
+#include "Multiplication.hpp"
+#include "Evaluation.hpp"
+#include "ThreadPool.hpp"
+#include "Stats.hpp"
+
+using std::vector;
+
+
+enum class Execution {
+    Sequential,
+    Parallel
+};
+
+// Inputs below these sizes run sequentially without touching the pool.
+// Every task writes to its own buffer and partial results are combined in a
+// fixed order, so the output does not depend on scheduling or pool size. The
+// buffers shared with the tasks are sized on the calling thread and so come
+// from its ArenaScope; scratch a task allocates itself follows the scope of
+// the thread that runs it.
+struct ParallelThresholds {
+    static inline size_t multiply = 2048;
+    static inline size_t evaluate = 1 << 16;
+    static inline size_t depth = 4;
+};
+
+// Karatsuba operand sums for integer coefficients wrap modulo 2^W like the
+// sequential multiplication ring does, instead of overflowing a signed type.
+template<class T>
+T WrappingSum(const T& lhs, const T& rhs) {
+    if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        typedef typename std::make_unsigned<T>::type U;
+        return static_cast<T>(static_cast<U>(lhs) + static_cast<U>(rhs));
+    } else {
+        return lhs + rhs;
+    }
+}
+
+template<class T>
+T WrappingDifference(const T& lhs, const T& rhs) {
+    if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        typedef typename std::make_unsigned<T>::type U;
+        return static_cast<T>(static_cast<U>(lhs) - static_cast<U>(rhs));
+    } else {
+        return lhs - rhs;
+    }
+}
+
+template<class T>
+void ParallelMultiply(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out,
+                      ThreadPool& pool, size_t depth);
+
+// Splits the longer operand into blocks as long as the shorter one; block
+// products are computed in parallel and summed in block order.
+template<class T>
+void ParallelMultiplyBlocks(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out,
+                            ThreadPool& pool) {
+    size_t block = std::max(rhs_size, ParallelThresholds::multiply);
+    size_t blocks = (lhs_size + block - 1) / block;
+    ArenaVector<ArenaVector<T> > products(blocks);
+    for (size_t index = 0; index < blocks; ++index) {
+        products[index].resize(std::min(block, lhs_size - index * block) + rhs_size - 1);
+    }
+    pool.ParallelFor(blocks, [&](size_t index) {
+        size_t offset = index * block;
+        size_t size = std::min(block, lhs_size - offset);
+        MultiplyCoefficients(lhs + offset, size, rhs, rhs_size, &products[index][0]);
+    });
+
+    std::fill(out, out + lhs_size + rhs_size - 1, T());
+    for (size_t index = 0; index < blocks; ++index) {
+        T* target = out + index * block;
+        for (size_t coefficient = 0; coefficient < products[index].size(); ++coefficient) {
+            target[coefficient] = WrappingSum(target[coefficient], products[index][coefficient]);
+        }
+    }
+}
+
+// One Karatsuba level with its three half-size products run as tasks.
+template<class T>
+void ParallelKaratsuba(const T* lhs, const T* rhs, size_t size, T* out, ThreadPool& pool, size_t depth) {
+    size_t low = size / 2;
+    size_t high = size - low;
+
+    ArenaVector<T> lhs_sum(lhs + low, lhs + size);
+    ArenaVector<T> rhs_sum(rhs + low, rhs + size);
+    for (size_t index = 0; index < low; ++index) {
+        lhs_sum[index] = WrappingSum(lhs_sum[index], lhs[index]);
+        rhs_sum[index] = WrappingSum(rhs_sum[index], rhs[index]);
+    }
+
+    ArenaVector<T> low_product(2 * low - 1);
+    ArenaVector<T> high_product(2 * high - 1);
+    ArenaVector<T> middle(2 * high - 1);
+    pool.ParallelFor(3, [&](size_t index) {
+        if (index == 0) {
+            ParallelMultiply(lhs, low, rhs, low, &low_product[0], pool, depth - 1);
+        } else if (index == 1) {
+            ParallelMultiply(lhs + low, high, rhs + low, high, &high_product[0], pool, depth - 1);
+        } else {
+            ParallelMultiply(&lhs_sum[0], high, &rhs_sum[0], high, &middle[0], pool, depth - 1);
+        }
+    });
+
+    std::fill(out, out + 2 * size - 1, T());
+    for (size_t index = 0; index < low_product.size(); ++index) {
+        out[index] = low_product[index];
+        middle[index] = WrappingDifference(middle[index], low_product[index]);
+    }
+    for (size_t index = 0; index < high_product.size(); ++index) {
+        out[2 * low + index] = high_product[index];
+        middle[index] = WrappingDifference(middle[index], high_product[index]);
+    }
+    for (size_t index = 0; index < middle.size(); ++index) {
+        out[low + index] = WrappingSum(out[low + index], middle[index]);
+    }
+}
+
+template<class T>
+void ParallelMultiply(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out,
+                      ThreadPool& pool, size_t depth) {
+    if (lhs_size < rhs_size) {
+        std::swap(lhs, rhs);
+        std::swap(lhs_size, rhs_size);
+    }
+
+    if (depth == 0 || lhs_size < std::max<size_t>(ParallelThresholds::multiply, 4)) {
+        MultiplyCoefficients(lhs, lhs_size, rhs, rhs_size, out);
+        return;
+    }
+    if (lhs_size >= 2 * rhs_size || rhs_size < ParallelThresholds::multiply) {
+        ParallelMultiplyBlocks(lhs, lhs_size, rhs, rhs_size, out, pool);
+        return;
+    }
+
+    CountStat(StatCounter::Karatsuba);
+    if (lhs_size == rhs_size) {
+        ParallelKaratsuba(lhs, rhs, lhs_size, out, pool, depth);
+        return;
+    }
+    ArenaVector<T> padded(rhs, rhs + rhs_size);
+    padded.resize(lhs_size);
+    ArenaVector<T> product(2 * lhs_size - 1);
+    ParallelKaratsuba(lhs, &padded[0], lhs_size, &product[0], pool, depth);
+    std::copy(product.begin(), product.begin() + lhs_size + rhs_size - 1, out);
+}
+
+template<class T>
+void MultiplyCoefficients(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out,
+                          Execution execution) {
+    if (execution == Execution::Parallel && std::max(lhs_size, rhs_size) >= ParallelThresholds::multiply) {
+        ParallelMultiply(lhs, lhs_size, rhs, rhs_size, out, ThreadPool::Shared(), ParallelThresholds::depth);
+        return;
+    }
+    MultiplyCoefficients(lhs, lhs_size, rhs, rhs_size, out);
+}
+
+// Points are independent, so blocks of them are evaluated as separate tasks.
+template<class T>
+void EvaluateCoefficients(const T* coefficients, size_t size, const T* points, size_t count, T* values,
+                          Execution execution) {
+    if (execution == Execution::Sequential || size * count < ParallelThresholds::evaluate) {
+        EvaluateCoefficients(coefficients, size, points, count, values);
+        return;
+    }
+
+    ThreadPool& pool = ThreadPool::Shared();
+    size_t block = std::max(ParallelThresholds::evaluate / size, size);
+    block = std::max(block, (count + 4 * pool.Size() - 1) / (4 * pool.Size()));
+    size_t blocks = (count + block - 1) / block;
+    pool.ParallelFor(blocks, [&](size_t index) {
+        size_t offset = index * block;
+        EvaluateCoefficients(coefficients, size, points + offset, std::min(block, count - offset), values + offset);
+    });
+}
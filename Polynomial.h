@@ -1,20 +1,135 @@
 #pragma once
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
+#include "Arena.hpp"
+#include "SmallVector.hpp"
+#include "Stats.hpp"
+#include "Gcd.hpp"
+#include "Composition.hpp"
+#include "Expression.hpp"
+#include "Parallel.hpp"
+
+
+// Constants, and polynomials of degree up to 8 over word-sized coefficients,
+// keep their coefficients inside the object and never touch the heap.
+template<class T>
+using PolynomialCoefficients = SmallVector<T, std::max<size_t>(1, 72 / sizeof(T))>;
 
 template<class T>
 class Polynomial {
 private:
-    std::vector<T> coefficients;
+    typedef PolynomialCoefficients<T> Coefficients;
+
+    Coefficients coefficients;
     int degree;
 
+    explicit Polynomial(Coefficients&& coefs);
+
+    static Coefficients Product(const Polynomial<T>& lhs, const Polynomial<T>& rhs,
+                                  Execution execution = Execution::Sequential);
+
+    void DivideInPlace(const Polynomial<T>& rhs, Coefficients& quotient);
+
+    template<class E>
+    void AssignExpression(E&& expression);
+
+    Polynomial<T>& AddScaled(const Polynomial<T>& other, const T& factor);
+
+    void SetCoefficient(size_t index, const T& value);
+
+    template<class U>
+    friend class PolynomialReference;
+
+    template<class U>
+    friend class PolynomialValue;
+
+    template<class U>
+    friend class PolynomialReader;
+
 public:
+    typedef T value_type;
+    typedef typename Coefficients::const_iterator const_iterator;
+
+    // Writable coefficient handle returned by the non-const operator[]. Writes
+    // go through SetCoefficient, so the leading coefficient is never zero and
+    // const members never have to normalize the polynomial.
+    class Reference {
+    private:
+        Polynomial<T>* polynomial;
+        size_t index;
+
+    public:
+        Reference(Polynomial<T>* polynomial, size_t index);
+
+        operator const T&() const;
+
+        Reference& operator =(const T& value);
+        Reference& operator =(const Reference& other);
+        Reference& operator +=(const T& value);
+        Reference& operator -=(const T& value);
+        Reference& operator *=(const T& value);
+        Reference& operator /=(const T& value);
+
+        friend bool operator ==(const Reference& lhs, const Reference& rhs)
+        {
+            return static_cast<const T&>(lhs) == static_cast<const T&>(rhs);
+        }
+
+        template<class U>
+        friend bool operator ==(const Reference& lhs, const U& rhs)
+        {
+            return static_cast<const T&>(lhs) == rhs;
+        }
+
+        template<class U>
+        friend bool operator ==(const U& lhs, const Reference& rhs)
+        {
+            return lhs == static_cast<const T&>(rhs);
+        }
+
+        friend bool operator !=(const Reference& lhs, const Reference& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        template<class U>
+        friend bool operator !=(const Reference& lhs, const U& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        template<class U>
+        friend bool operator !=(const U& lhs, const Reference& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend std::ostream& operator <<(std::ostream& stream, const Reference& reference)
+        {
+            return stream << static_cast<const T&>(reference);
+        }
+    };
+
     Polynomial(const T& coef = T());
 
     template <class IterType>
     Polynomial(IterType, IterType);
 
+    // A moved-from polynomial is left as the zero polynomial.
+    Polynomial(const Polynomial<T>&) = default;
+    Polynomial(Polynomial<T>&&) noexcept;
+
+    Polynomial<T>& operator =(const Polynomial<T>&) = default;
+    Polynomial<T>& operator =(Polynomial<T>&&);
+
+    template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+    Polynomial(E&& expression);
+
+    template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+    Polynomial<T>& operator =(E&& expression);
+
     bool operator ==(const Polynomial<T>&) const;
     bool operator !=(const Polynomial<T>&) const;
     bool operator <(const Polynomial<T>&) const;
@@ -25,18 +140,29 @@ public:
     Polynomial<T>& operator +=(const Polynomial<T>&);
     Polynomial<T>& operator -=(const Polynomial<T>&);
     Polynomial<T>& operator *=(const Polynomial<T>&);
+    Polynomial<T>& operator *=(const T&);
+
+    template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+    Polynomial<T>& operator +=(E&& expression);
+    template<class E, class = typename std::enable_if<IsPolynomialExpression<E>::value>::type>
+    Polynomial<T>& operator -=(E&& expression);
 
     const T& operator[](size_t) const;
-    T& operator[](size_t);
+    Reference operator[](size_t);
 
     T operator()(const T) const;
 
+    void Evaluate(const T* points, size_t count, T* values,
+                  Execution execution = Execution::Sequential) const;
+    std::vector<T> Evaluate(const std::vector<T>& points,
+                            Execution execution = Execution::Sequential) const;
+
     int Degree() const;
 
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator end() const;
+    Polynomial<T> Derivative() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
 
     void RawDivide(const Polynomial<T>& rhs, Polynomial<T>& quotient, Polynomial<T>& mod) const;
 
@@ -44,43 +170,102 @@ public:
 
     void RecountDegree();
 
-    friend Polynomial operator +(const Polynomial& lhs, const Polynomial& rhs)
+    friend SumExpression<T, PolynomialReference<T>, PolynomialReference<T>, false>
+    operator +(const Polynomial& lhs, const Polynomial& rhs)
     {
-        Polynomial temp(lhs);
-        temp += rhs;
-        return temp;
+        return {PolynomialReference<T>(lhs), PolynomialReference<T>(rhs)};
     }
-    
-    friend Polynomial operator -(const Polynomial& lhs, const Polynomial& rhs)
+
+    friend SumExpression<T, PolynomialReference<T>, PolynomialReference<T>, true>
+    operator -(const Polynomial& lhs, const Polynomial& rhs)
+    {
+        return {PolynomialReference<T>(lhs), PolynomialReference<T>(rhs)};
+    }
+
+    // A scalar becomes a constant polynomial owned by the node, so the node
+    // does not refer to a temporary that is gone by the time it is read.
+    friend SumExpression<T, PolynomialReference<T>, PolynomialValue<T>, false>
+    operator +(const Polynomial& lhs, const T& rhs)
     {
-        Polynomial temp(lhs);
-        temp -= rhs;
-        return temp;
+        return {PolynomialReference<T>(lhs), PolynomialValue<T>(Polynomial(rhs))};
+    }
+
+    friend SumExpression<T, PolynomialValue<T>, PolynomialReference<T>, false>
+    operator +(const T& lhs, const Polynomial& rhs)
+    {
+        return {PolynomialValue<T>(Polynomial(lhs)), PolynomialReference<T>(rhs)};
+    }
+
+    friend SumExpression<T, PolynomialReference<T>, PolynomialValue<T>, true>
+    operator -(const Polynomial& lhs, const T& rhs)
+    {
+        return {PolynomialReference<T>(lhs), PolynomialValue<T>(Polynomial(rhs))};
+    }
+
+    friend SumExpression<T, PolynomialValue<T>, PolynomialReference<T>, true>
+    operator -(const T& lhs, const Polynomial& rhs)
+    {
+        return {PolynomialValue<T>(Polynomial(lhs)), PolynomialReference<T>(rhs)};
     }
 
     friend Polynomial operator *(const Polynomial& lhs, const Polynomial& rhs)
     {
-        Polynomial temp(lhs);
-        temp *= rhs;
-        return temp;
+        return Polynomial(Product(lhs, rhs));
+    }
+
+    friend Polynomial operator *(Polynomial&& lhs, const Polynomial& rhs)
+    {
+        lhs *= rhs;
+        return std::move(lhs);
+    }
+
+    friend Polynomial operator *(const Polynomial& lhs, Polynomial&& rhs)
+    {
+        rhs *= lhs;
+        return std::move(rhs);
+    }
+
+    friend Polynomial operator *(Polynomial&& lhs, Polynomial&& rhs)
+    {
+        lhs *= rhs;
+        return std::move(lhs);
+    }
+
+    friend Polynomial Multiply(const Polynomial& lhs, const Polynomial& rhs, Execution execution)
+    {
+        return Polynomial(Product(lhs, rhs, execution));
     }
 
     friend Polynomial operator /(const Polynomial& lhs, const Polynomial& rhs)
     {
-        Polynomial quotient;
-        Polynomial mod;
-        lhs.RawDivide(rhs, quotient, mod);
-        return quotient;
+        Polynomial mod(lhs);
+        Coefficients quotient;
+        mod.DivideInPlace(rhs, quotient);
+        return Polynomial(std::move(quotient));
+    }
+
+    friend Polynomial operator /(Polynomial&& lhs, const Polynomial& rhs)
+    {
+        Coefficients quotient;
+        lhs.DivideInPlace(rhs, quotient);
+        return Polynomial(std::move(quotient));
     }
 
     friend Polynomial operator %(const Polynomial& lhs, const Polynomial& rhs)
     {
-        Polynomial quotient;
-        Polynomial mod;
-        lhs.RawDivide(rhs, quotient, mod);
+        Polynomial mod(lhs);
+        Coefficients quotient;
+        mod.DivideInPlace(rhs, quotient);
         return mod;
     }
 
+    friend Polynomial operator %(Polynomial&& lhs, const Polynomial& rhs)
+    {
+        Coefficients quotient;
+        lhs.DivideInPlace(rhs, quotient);
+        return std::move(lhs);
+    }
+
     friend Polynomial operator ,(const Polynomial& lhs, const Polynomial& rhs)
     {
         Polynomial quotient, mod;
@@ -92,16 +277,84 @@ public:
             mod = lhs;
         }
 
-        while (!(mod.degree == 0 && mod[0] == 0)) {
-            Polynomial temp(mod);
-            mod = quotient % mod;
-            quotient = temp;
+        // Remainders of integer polynomials blow up, so coefficient types with
+        // a gcd of their own, such as BigInt, take it from there instead.
+        if constexpr (CoefficientAlgorithms<T>::has_gcd) {
+            ArenaVector<T> gcd = CoefficientAlgorithms<T>::Gcd(
+                ArenaVector<T>(quotient.coefficients.begin(), quotient.coefficients.end()),
+                ArenaVector<T>(mod.coefficients.begin(), mod.coefficients.end()));
+            quotient.coefficients.assign(gcd.begin(), gcd.end());
+            quotient.RecountDegree();
+        } else if constexpr (CoefficientTraits<T>::is_field) {
+            ArenaVector<T> gcd = PolynomialGcd(ArenaVector<T>(quotient.coefficients.begin(), quotient.coefficients.end()),
+                                               ArenaVector<T>(mod.coefficients.begin(), mod.coefficients.end()));
+            quotient.coefficients.assign(gcd.begin(), gcd.end());
+            quotient.RecountDegree();
+        } else {
+            while (!(mod.degree == 0 && mod[0] == 0)) {
+                quotient = std::move(quotient) % mod;
+                std::swap(quotient, mod);
+            }
         }
         return quotient;
     }
+
+    // gcd = lhs_factor * lhs + rhs_factor * rhs. Over a field the gcd is the one
+    // operator, finds; over the integers there is no division, and the result is
+    // the primitive gcd times the smallest constant the cofactors allow, with a
+    // positive leading coefficient.
+    friend Polynomial GcdEx(const Polynomial& lhs, const Polynomial& rhs,
+                            Polynomial& lhs_factor, Polynomial& rhs_factor)
+    {
+        GcdMatrix<T> cofactors;
+        Polynomial gcd;
+        ArenaVector<T> first(lhs.coefficients.begin(), lhs.coefficients.begin() + lhs.degree + 1);
+        ArenaVector<T> second(rhs.coefficients.begin(), rhs.coefficients.begin() + rhs.degree + 1);
+        ArenaVector<T> result;
+        if constexpr (CoefficientTraits<T>::is_field) {
+            result = PolynomialGcd(std::move(first), std::move(second), &cofactors);
+        } else {
+            result = PrimitiveGcdEx(first, second, cofactors);
+        }
+        gcd.coefficients.assign(result.begin(), result.end());
+        gcd.RecountDegree();
+        lhs_factor.coefficients.assign(cofactors.entries[0][0].begin(), cofactors.entries[0][0].end());
+        lhs_factor.RecountDegree();
+        rhs_factor.coefficients.assign(cofactors.entries[0][1].begin(), cofactors.entries[0][1].end());
+        rhs_factor.RecountDegree();
+        return gcd;
+    }
+
+    // outer(inner), splitting outer into halves so that the work is a few
+    // large products instead of one product per coefficient.
+    friend Polynomial Compose(const Polynomial& outer, const Polynomial& inner)
+    {
+        ArenaVector<T> result = ComposeCoefficients(&outer.coefficients[0], outer.degree + 1,
+            ArenaVector<T>(inner.coefficients.begin(), inner.coefficients.begin() + inner.degree + 1));
+        Polynomial composition;
+        composition.coefficients.assign(result.begin(), result.end());
+        composition.RecountDegree();
+        return composition;
+    }
+
+    // polynomial(x + shift).
+    friend Polynomial TaylorShift(const Polynomial& polynomial, const T& shift)
+    {
+        ArenaVector<T> result(polynomial.coefficients.begin(), polynomial.coefficients.begin() + polynomial.degree + 1);
+        TaylorShiftCoefficients(result, shift);
+        Polynomial shifted;
+        shifted.coefficients.assign(result.begin(), result.end());
+        shifted.RecountDegree();
+        return shifted;
+    }
 };
 
 
+// Polynomial of degree below points.size() that takes values[i] at points[i];
+// the points must be distinct and the coefficients a field.
+template<class T>
+Polynomial<T> Interpolate(const std::vector<T>& points, const std::vector<T>& values);
+
 template <class T>
 std::ostream& operator <<(std::ostream&, const Polynomial<T>&);
 
@@ -4,6 +4,12 @@
 #include <string>
 #include <algorithm>
 
+#include "Multiplication.hpp"
+#include "Division.hpp"
+#include "Evaluation.hpp"
+#include "Interpolation.hpp"
+#include "Stats.hpp"
+
 using std::vector;
 using std::string;
 
@@ -13,15 +19,86 @@ Polynomial<T>::Polynomial(const T& coef) {
     degree = 0;
 }
 
+// The source gives up its coefficients but keeps the invariant that there is
+// at least one, so it stays usable as zero.
+template<class T>
+Polynomial<T>::Polynomial(Polynomial<T>&& other) noexcept
+    : coefficients(std::move(other.coefficients)), degree(other.degree) {
+    other.coefficients.assign(1, T());
+    other.degree = 0;
+}
+
+template<class T>
+Polynomial<T>& Polynomial<T>::operator =(Polynomial<T>&& other) {
+    if (this != &other) {
+        coefficients = std::move(other.coefficients);
+        degree = other.degree;
+        other.coefficients.assign(1, T());
+        other.degree = 0;
+    }
+    return *this;
+}
+
+template<class T>
+Polynomial<T>::Polynomial(Coefficients&& coefs) : coefficients(std::move(coefs)) {
+    if (coefficients.empty()) {
+        coefficients.push_back(T());
+    }
+    RecountDegree();
+}
+
+template<class T>
+template<class E, class>
+Polynomial<T>::Polynomial(E&& expression) : degree(0) {
+    AssignExpression(std::forward<E>(expression));
+}
+
+template<class T>
+template<class E, class>
+Polynomial<T>& Polynomial<T>::operator =(E&& expression) {
+    AssignExpression(std::forward<E>(expression));
+    return *this;
+}
+
+template<class T>
+template<class E>
+void Polynomial<T>::AssignExpression(E&& expression) {
+    CountStat(StatCounter::Expressions);
+    size_t size = expression.Size();
+    Polynomial<T>* buffer_owner = 0;
+    if constexpr (!std::is_lvalue_reference<E>::value) {
+        buffer_owner = expression.Reusable(size);
+    }
+
+    Coefficients result;
+    if (buffer_owner) {
+        Coefficients& buffer = buffer_owner->coefficients;
+        buffer.resize(size);
+        for (size_t index = 0; index < size; ++index) {
+            buffer[index] = expression.Coefficient(index);
+        }
+        result = std::move(buffer);
+    } else {
+        result.reserve(size);
+        for (size_t index = 0; index < size; ++index) {
+            result.push_back(expression.Coefficient(index));
+        }
+    }
+
+    coefficients = std::move(result);
+    RecountDegree();
+}
+
 template<class T>
 template<class IterType>
 Polynomial<T>::Polynomial(IterType begin, IterType end) {
     degree = std::distance(begin, end) - 1;
     IterType iter = end - 1;
-    for(iter; iter != begin; --iter) {
+    for (; iter != begin; --iter) {
         coefficients.push_back(*iter);
     }
     coefficients.push_back(*iter);
+    RecountDegree();
 }
 
 template<class T>
@@ -36,8 +113,10 @@ bool Polynomial<T>::operator !=(const Polynomial<T>& other) const {
 
 template<class T>
 void Polynomial<T>::RecountDegree() {
+    CountStat(StatCounter::Normalizations);
     while (coefficients.size() > 1 && coefficients.back() == T()) {
             coefficients.pop_back();
+            CountStat(StatCounter::TrimmedCoefficients);
         }
 
     degree = coefficients.size() - 1;
@@ -45,6 +124,7 @@ void Polynomial<T>::RecountDegree() {
 
 template<class T>
 Polynomial<T>& Polynomial<T>::operator +=(const Polynomial<T>& other) {
+    CountStat(StatCounter::Additions);
     size_t my_degree = Degree();
     size_t other_degree = other.Degree();
 
@@ -53,9 +133,7 @@ Polynomial<T>& Polynomial<T>::operator +=(const Polynomial<T>& other) {
         degree = other_degree;
     }
 
-    for (int index = 0; index <= other_degree; ++index) {
-        coefficients[index] += other.coefficients[index];
-    }
+    AddCoefficients(&coefficients[0], &other.coefficients[0], other_degree + 1);
 
     RecountDegree();
 
@@ -64,35 +142,88 @@ Polynomial<T>& Polynomial<T>::operator +=(const Polynomial<T>& other) {
 
 template<class T>
 Polynomial<T>& Polynomial<T>::operator -=(const Polynomial<T>& other) {
-    if (degree < other.degree) {
-        coefficients.resize(other.degree + 1);
-        degree = other.degree;
-    }
+    CountStat(StatCounter::Subtractions);
+    size_t my_degree = Degree();
+    size_t other_degree = other.Degree();
 
-    for (int index = 0; index <= other.degree; ++index) {
-        coefficients[index] -= other.coefficients[index];
+    if (my_degree < other_degree) {
+        coefficients.resize(other_degree + 1);
+        degree = other_degree;
     }
 
+    SubtractCoefficients(&coefficients[0], &other.coefficients[0], other_degree + 1);
+
     RecountDegree();
 
     return *this;
 }
 
 template<class T>
-Polynomial<T>& Polynomial<T>::operator *=(const Polynomial<T>& other) {
+Polynomial<T>& Polynomial<T>::AddScaled(const Polynomial<T>& other, const T& factor) {
+    CountStat(StatCounter::Additions);
+    CountStat(StatCounter::CoefficientMultiplies, other.Degree() + 1);
     size_t my_degree = Degree();
     size_t other_degree = other.Degree();
 
-    vector<T> temp_coefficients(degree + other_degree + 1);
+    if (my_degree < other_degree) {
+        coefficients.resize(other_degree + 1);
+        degree = other_degree;
+    }
+
+    AxpyCoefficients(&coefficients[0], &other.coefficients[0], other_degree + 1, factor);
 
-    for(int index = 0; index <= my_degree; ++index) {
-        for(int other_index = 0; other_index <= other_degree; ++other_index) {
-            temp_coefficients[index + other_index] += coefficients[index] * other.coefficients[other_index];
-        }
+    RecountDegree();
+
+    return *this;
+}
+
+template<class T>
+template<class E, class>
+Polynomial<T>& Polynomial<T>::operator +=(E&& expression) {
+    if constexpr (std::is_same<typename std::decay<E>::type, ScaledExpression<T, PolynomialReference<T> > >::value) {
+        return AddScaled(expression.Operand().Referenced(), expression.Factor());
+    } else {
+        return *this = *this + std::forward<E>(expression);
+    }
+}
+
+template<class T>
+template<class E, class>
+Polynomial<T>& Polynomial<T>::operator -=(E&& expression) {
+    if constexpr (std::is_same<typename std::decay<E>::type, ScaledExpression<T, PolynomialReference<T> > >::value) {
+        return AddScaled(expression.Operand().Referenced(), T() - expression.Factor());
+    } else {
+        return *this = *this - std::forward<E>(expression);
     }
+}
+
+template<class T>
+typename Polynomial<T>::Coefficients Polynomial<T>::Product(const Polynomial<T>& lhs, const Polynomial<T>& rhs, Execution execution) {
+    CountStat(StatCounter::Multiplications);
+    size_t lhs_degree = lhs.Degree();
+    size_t rhs_degree = rhs.Degree();
+
+    Coefficients product(lhs_degree + rhs_degree + 1);
+    MultiplyCoefficients(&lhs.coefficients[0], lhs_degree + 1,
+                         &rhs.coefficients[0], rhs_degree + 1, &product[0], execution);
+    return product;
+}
+
+template<class T>
+Polynomial<T>& Polynomial<T>::operator *=(const Polynomial<T>& other) {
+    Coefficients product = Product(*this, other);
+    coefficients = std::move(product);
+    RecountDegree();
+
+    return *this;
+}
 
-    coefficients = temp_coefficients;
-    degree += other_degree;
+template<class T>
+Polynomial<T>& Polynomial<T>::operator *=(const T& factor) {
+    CountStat(StatCounter::Scalings);
+    CountStat(StatCounter::CoefficientMultiplies, coefficients.size());
+    ScaleCoefficients(&coefficients[0], coefficients.size(), factor);
+    RecountDegree();
 
     return *this;
 }
@@ -103,7 +234,7 @@ bool Polynomial<T>::operator <(const Polynomial<T>& other) const {
     size_t other_degree = other.Degree();
 
     if (my_degree != other_degree) {
-        return degree < other_degree;
+        return my_degree < other_degree;
     }
 
     return coefficients < other.coefficients;
@@ -135,100 +266,190 @@ const T& Polynomial<T>::operator[](size_t index) const {
 }
 
 template<class T>
-T& Polynomial<T>::operator[](size_t index) {
-    size_t my_degree = Degree();
+typename Polynomial<T>::Reference Polynomial<T>::operator[](size_t index) {
+    return Reference(this, index);
+}
 
-    if (index > my_degree) {
+template<class T>
+void Polynomial<T>::SetCoefficient(size_t index, const T& value) {
+    if (index > static_cast<size_t>(degree)) {
+        if (value == T()) {
+            return;
+        }
         degree = index;
         coefficients.resize(degree + 1);
     }
-    return coefficients[index];
+
+    coefficients[index] = value;
+    if (index == static_cast<size_t>(degree) && value == T()) {
+        RecountDegree();
+    }
 }
 
 template<class T>
-T Polynomial<T>::operator()(const T arg) const {
-    T value = T();
-    T arg_pow = 1;
+Polynomial<T>::Reference::Reference(Polynomial<T>* polynomial, size_t index)
+    : polynomial(polynomial), index(index) {}
 
-    for (typename vector<T>::const_iterator iter = coefficients.begin(); iter != coefficients.end(); ++iter) {
-        value += *iter * arg_pow;
-        arg_pow *= arg;
+template<class T>
+Polynomial<T>::Reference::operator const T&() const {
+    static const T zero = T();
+    if (index > static_cast<size_t>(polynomial->degree)) {
+        return zero;
     }
+    return polynomial->coefficients[index];
+}
 
-    return value;
+template<class T>
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator =(const T& value) {
+    polynomial->SetCoefficient(index, value);
+    return *this;
 }
 
 template<class T>
-void Polynomial<T>::Shift(size_t shift) {
-    if (shift == 0) {
-        return;
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator =(const Reference& other) {
+    polynomial->SetCoefficient(index, static_cast<const T&>(other));
+    return *this;
+}
+
+template<class T>
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator +=(const T& value) {
+    polynomial->SetCoefficient(index, static_cast<const T&>(*this) + value);
+    return *this;
+}
+
+template<class T>
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator -=(const T& value) {
+    polynomial->SetCoefficient(index, static_cast<const T&>(*this) - value);
+    return *this;
+}
+
+template<class T>
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator *=(const T& value) {
+    polynomial->SetCoefficient(index, static_cast<const T&>(*this) * value);
+    return *this;
+}
+
+template<class T>
+typename Polynomial<T>::Reference& Polynomial<T>::Reference::operator /=(const T& value) {
+    polynomial->SetCoefficient(index, static_cast<const T&>(*this) / value);
+    return *this;
+}
+
+template<class T>
+T Polynomial<T>::operator()(const T arg) const {
+    CountStat(StatCounter::Evaluations);
+    return HornerValue(&coefficients[0], coefficients.size(), arg);
+}
+
+template<class T>
+void Polynomial<T>::Evaluate(const T* points, size_t count, T* values, Execution execution) const {
+    CountStat(StatCounter::Evaluations, count);
+    size_t my_degree = Degree();
+    EvaluateCoefficients(&coefficients[0], my_degree + 1, points, count, values, execution);
+}
+
+template<class T>
+vector<T> Polynomial<T>::Evaluate(const vector<T>& points, Execution execution) const {
+    vector<T> values(points.size());
+    if (!points.empty()) {
+        Evaluate(&points[0], points.size(), &values[0], execution);
     }
+    return values;
+}
 
-    vector<T> temp(shift);
-    for(int i = 0; i <= degree; ++i) {
-        temp.push_back(coefficients[i]);
+template<class T>
+void Polynomial<T>::Shift(size_t shift) {
+    if (shift == 0 || (degree == 0 && coefficients[0] == T())) {
+        return;
     }
 
-    coefficients = temp;
+    coefficients.insert(coefficients.begin(), shift, T());
     degree += shift;
 }
 
 template<class T>
-void Polynomial<T>::RawDivide(const Polynomial<T>& rhs,
-                              Polynomial<T>& quotient, Polynomial<T>& mod) const {
-
+void Polynomial<T>::DivideInPlace(const Polynomial<T>& rhs, Coefficients& quotient) {
+    CountStat(StatCounter::Divisions);
     size_t my_degree = Degree();
     size_t rhs_degree = rhs.Degree();
 
-    if (rhs_degree == 0 && rhs[0] == 0) {
+    if (rhs_degree == 0 && rhs.coefficients[0] == 0) {
         throw std::overflow_error("Divide by zero");
     }
 
     if (my_degree < rhs_degree) {
-        quotient = Polynomial<T>();
-        mod = rhs;
+        quotient.assign(1, T());
+        *this = rhs;
         return;
     }
 
-    mod = *this;
-    while(mod.Degree() >= rhs_degree && !(mod[0] == 0 && mod.Degree() == 0)) {
-        T coef = mod[mod.Degree()] / rhs[rhs_degree];
-        if (coef == 0) {
-            break;
-        }
-        int degree_diff = mod.Degree() - rhs_degree;
-        Polynomial<T> temp(coef);
-        temp.Shift(degree_diff);
-        quotient += temp;
-        mod -= temp * rhs;
+    if (&rhs == this) {
+        quotient.assign(1, T(1));
+        coefficients.assign(1, T());
+        RecountDegree();
+        return;
+    }
+
+    quotient.resize(my_degree - rhs_degree + 1);
+    size_t remainder_size = DivideCoefficients(&coefficients[0], my_degree + 1,
+                                               &rhs.coefficients[0], rhs_degree + 1, &quotient[0]);
+    if (remainder_size == 0) {
+        coefficients.assign(1, T());
+    } else {
+        coefficients.resize(remainder_size);
     }
+    RecountDegree();
+}
+
+template<class T>
+void Polynomial<T>::RawDivide(const Polynomial<T>& rhs,
+                              Polynomial<T>& quotient, Polynomial<T>& mod) const {
+    Polynomial<T> remainder(*this);
+    Coefficients quotient_coefficients;
+    remainder.DivideInPlace(rhs, quotient_coefficients);
+
+    quotient = Polynomial<T>(std::move(quotient_coefficients));
+    mod = std::move(remainder);
 }
 
 template<class T>
 int Polynomial<T>::Degree() const {
-    Polynomial<T> * non_const = const_cast<Polynomial<T>*>(this);
-    non_const->RecountDegree();
     return degree;
 }
 
 template<class T>
-typename vector<T>::iterator Polynomial<T>::begin() {
-    return coefficients.begin();
+Polynomial<T> Polynomial<T>::Derivative() const {
+    if (degree == 0) {
+        return Polynomial<T>();
+    }
+    Coefficients derivative(degree);
+    for (int power = 1; power <= degree; ++power) {
+        derivative[power - 1] = coefficients[power] * T(power);
+    }
+    return Polynomial<T>(std::move(derivative));
 }
 
 template<class T>
-typename vector<T>::const_iterator Polynomial<T>::begin() const {
+typename Polynomial<T>::const_iterator Polynomial<T>::begin() const {
     return coefficients.begin();
 }
 
 template<class T>
-typename vector<T>::iterator Polynomial<T>::end() {
+typename Polynomial<T>::const_iterator Polynomial<T>::end() const {
     return coefficients.end() - 1;
 }
 
 template<class T>
-typename vector<T>::const_iterator Polynomial<T>::end() const {
-    return coefficients.end() - 1;
+Polynomial<T> Interpolate(const vector<T>& points, const vector<T>& values) {
+    if (points.size() != values.size()) {
+        throw std::invalid_argument("Points and values differ in number");
+    }
+    if (points.empty()) {
+        return Polynomial<T>();
+    }
+    ArenaVector<T> coefficients(points.size());
+    InterpolateCoefficients(&points[0], &values[0], points.size(), &coefficients[0]);
+    return Polynomial<T>(coefficients.rbegin(), coefficients.rend());
 }
 
 template<class T>
@@ -0,0 +1,85 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstddef>
+
+#include "Polynomial.h"
+
+
+// Many polynomials of degree at most Degree() in one array, interleaved by
+// power: row k holds the coefficients of x^k of all Size() polynomials next to
+// each other. Every operation walks the rows, so the inner loops run over the
+// polynomials and vectorize across them. As in StaticPolynomial the leading
+// coefficients may be zero; the degree of the batch is only a bound.
+template<class T>
+class PolynomialBatch {
+private:
+    size_t count;
+    size_t degree;
+    ArenaVector<T> coefficients;
+
+    void CheckSize(const PolynomialBatch<T>& other) const;
+
+    void Grow(size_t new_degree);
+
+public:
+    typedef T value_type;
+
+    PolynomialBatch(size_t count, size_t degree);
+
+    explicit PolynomialBatch(const std::vector<Polynomial<T> >& polynomials);
+
+    size_t Size() const;
+
+    int Degree() const;
+
+    T* Row(size_t power);
+    const T* Row(size_t power) const;
+
+    T& operator()(size_t index, size_t power);
+    const T& operator()(size_t index, size_t power) const;
+
+    Polynomial<T> operator[](size_t index) const;
+
+    void Set(size_t index, const Polynomial<T>& polynomial);
+
+    bool operator ==(const PolynomialBatch<T>&) const;
+    bool operator !=(const PolynomialBatch<T>&) const;
+
+    PolynomialBatch<T>& operator +=(const PolynomialBatch<T>&);
+    PolynomialBatch<T>& operator -=(const PolynomialBatch<T>&);
+    PolynomialBatch<T>& operator *=(const PolynomialBatch<T>&);
+
+    // values[i] = polynomial i at points[i].
+    void Evaluate(const T* points, T* values) const;
+    std::vector<T> Evaluate(const std::vector<T>& points) const;
+
+    // Divides polynomial i by divisor i, whose coefficient of x^Degree() must
+    // be one; the remainder has degree below the divisor's.
+    void DivideByMonic(const PolynomialBatch<T>& divisor, PolynomialBatch<T>& quotient,
+                       PolynomialBatch<T>& remainder) const;
+
+    friend PolynomialBatch operator +(PolynomialBatch lhs, const PolynomialBatch& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend PolynomialBatch operator -(PolynomialBatch lhs, const PolynomialBatch& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend PolynomialBatch operator *(const PolynomialBatch& lhs, const PolynomialBatch& rhs)
+    {
+        lhs.CheckSize(rhs);
+        PolynomialBatch product(lhs.count, lhs.degree + rhs.degree);
+        for (size_t power = 0; power <= lhs.degree; ++power) {
+            for (size_t other = 0; other <= rhs.degree; ++other) {
+                MultiplyAddCoefficients(product.Row(power + other), lhs.Row(power), rhs.Row(other), lhs.count);
+            }
+        }
+        return product;
+    }
+};
+
+#include "PolynomialBatch.hpp"
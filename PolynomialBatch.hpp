@@ -0,0 +1,188 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+
+template<class T>
+PolynomialBatch<T>::PolynomialBatch(size_t count, size_t degree)
+    : count(count), degree(degree), coefficients(count * (degree + 1)) {}
+
+template<class T>
+PolynomialBatch<T>::PolynomialBatch(const std::vector<Polynomial<T> >& polynomials)
+    : count(polynomials.size()), degree(0) {
+    for (const Polynomial<T>& polynomial : polynomials) {
+        degree = std::max<size_t>(degree, polynomial.Degree());
+    }
+    coefficients.resize(count * (degree + 1));
+    for (size_t index = 0; index < count; ++index) {
+        Set(index, polynomials[index]);
+    }
+}
+
+template<class T>
+void PolynomialBatch<T>::CheckSize(const PolynomialBatch<T>& other) const {
+    if (count != other.count) {
+        throw std::invalid_argument("Batches differ in size");
+    }
+}
+
+// Rows of the new powers go after the existing ones, so nothing moves.
+template<class T>
+void PolynomialBatch<T>::Grow(size_t new_degree) {
+    if (new_degree > degree) {
+        coefficients.resize(count * (new_degree + 1));
+        degree = new_degree;
+    }
+}
+
+template<class T>
+size_t PolynomialBatch<T>::Size() const {
+    return count;
+}
+
+template<class T>
+int PolynomialBatch<T>::Degree() const {
+    return degree;
+}
+
+template<class T>
+T* PolynomialBatch<T>::Row(size_t power) {
+    return coefficients.data() + power * count;
+}
+
+template<class T>
+const T* PolynomialBatch<T>::Row(size_t power) const {
+    return coefficients.data() + power * count;
+}
+
+template<class T>
+T& PolynomialBatch<T>::operator()(size_t index, size_t power) {
+    return coefficients[power * count + index];
+}
+
+template<class T>
+const T& PolynomialBatch<T>::operator()(size_t index, size_t power) const {
+    return coefficients[power * count + index];
+}
+
+template<class T>
+Polynomial<T> PolynomialBatch<T>::operator[](size_t index) const {
+    if (index >= count) {
+        throw std::out_of_range("Out of range, no such polynomial in the batch");
+    }
+    std::vector<T> seq(degree + 1);
+    for (size_t power = 0; power <= degree; ++power) {
+        seq[degree - power] = (*this)(index, power);
+    }
+    return Polynomial<T>(seq.begin(), seq.end());
+}
+
+template<class T>
+void PolynomialBatch<T>::Set(size_t index, const Polynomial<T>& polynomial) {
+    if (index >= count || static_cast<size_t>(polynomial.Degree()) > degree) {
+        throw std::out_of_range("Polynomial does not fit in the batch");
+    }
+    typename Polynomial<T>::const_iterator source = polynomial.begin();
+    for (size_t power = 0; power <= degree; ++power) {
+        (*this)(index, power) = power <= static_cast<size_t>(polynomial.Degree()) ? source[power] : T();
+    }
+}
+
+template<class T>
+bool PolynomialBatch<T>::operator ==(const PolynomialBatch<T>& other) const {
+    if (count != other.count) {
+        return false;
+    }
+    size_t common = std::min(degree, other.degree) + 1;
+    if (!std::equal(Row(0), Row(common), other.Row(0))) {
+        return false;
+    }
+    const PolynomialBatch<T>& longer = degree > other.degree ? *this : other;
+    return std::all_of(longer.Row(common), longer.Row(longer.degree + 1), [](const T& coef) {
+        return coef == T();
+    });
+}
+
+template<class T>
+bool PolynomialBatch<T>::operator !=(const PolynomialBatch<T>& other) const {
+    return !(*this == other);
+}
+
+template<class T>
+PolynomialBatch<T>& PolynomialBatch<T>::operator +=(const PolynomialBatch<T>& other) {
+    CheckSize(other);
+    Grow(other.degree);
+    AddCoefficients(Row(0), other.Row(0), count * (other.degree + 1));
+    return *this;
+}
+
+template<class T>
+PolynomialBatch<T>& PolynomialBatch<T>::operator -=(const PolynomialBatch<T>& other) {
+    CheckSize(other);
+    Grow(other.degree);
+    SubtractCoefficients(Row(0), other.Row(0), count * (other.degree + 1));
+    return *this;
+}
+
+template<class T>
+PolynomialBatch<T>& PolynomialBatch<T>::operator *=(const PolynomialBatch<T>& other) {
+    PolynomialBatch<T> product = *this * other;
+    *this = std::move(product);
+    return *this;
+}
+
+template<class T>
+void PolynomialBatch<T>::Evaluate(const T* points, T* values) const {
+    std::copy(Row(degree), Row(degree + 1), values);
+    for (size_t power = degree; power-- > 0;) {
+        HornerStepCoefficients(values, points, Row(power), count);
+    }
+}
+
+template<class T>
+std::vector<T> PolynomialBatch<T>::Evaluate(const std::vector<T>& points) const {
+    if (points.size() != count) {
+        throw std::invalid_argument("Batches differ in size");
+    }
+    std::vector<T> values(count);
+    Evaluate(points.data(), values.data());
+    return values;
+}
+
+// Long division run on all polynomials at once: row power of the remainder
+// is the next quotient row, subtracted times every divisor row below the top.
+template<class T>
+void PolynomialBatch<T>::DivideByMonic(const PolynomialBatch<T>& divisor, PolynomialBatch<T>& quotient,
+                                       PolynomialBatch<T>& remainder) const {
+    CheckSize(divisor);
+    if (std::any_of(divisor.Row(divisor.degree), divisor.Row(divisor.degree + 1), [](const T& coef) {
+        return coef != T(1);
+    })) {
+        throw std::invalid_argument("Divisors must be monic");
+    }
+
+    PolynomialBatch<T> rest(*this);
+    if (degree < divisor.degree) {
+        quotient = PolynomialBatch<T>(count, 0);
+        remainder = std::move(rest);
+        return;
+    }
+
+    PolynomialBatch<T> result(count, degree - divisor.degree);
+    for (size_t power = degree + 1; power-- > divisor.degree;) {
+        size_t shift = power - divisor.degree;
+        std::copy(rest.Row(power), rest.Row(power + 1), result.Row(shift));
+        for (size_t other = 0; other < divisor.degree; ++other) {
+            MultiplySubtractCoefficients(rest.Row(shift + other), result.Row(shift), divisor.Row(other), count);
+        }
+    }
+    rest.coefficients.resize(count * std::max<size_t>(divisor.degree, 1));
+    rest.degree = divisor.degree == 0 ? 0 : divisor.degree - 1;
+    if (divisor.degree == 0) {
+        std::fill(rest.coefficients.begin(), rest.coefficients.end(), T());
+    }
+    quotient = std::move(result);
+    remainder = std::move(rest);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+#include "Polynomial.h"
+
+
+struct RootThresholds {
+    static inline size_t aberth_iterations = 500;
+    static inline size_t refine_iterations = 200;
+    static inline size_t parallel_refine = 16;
+};
+
+// Open interval of the real line holding exactly one root of the polynomial;
+// lower == upper when the root is a dyadic rational found exactly.
+struct RootInterval {
+    double lower;
+    double upper;
+};
+
+// All complex roots of a polynomial with floating point coefficients, repeated
+// by multiplicity and ordered by real and then imaginary part, found by the
+// Aberth-Ehrlich simultaneous iteration.
+template<class T>
+std::vector<std::complex<T> > ComplexRoots(const Polynomial<T>& polynomial);
+
+// Isolating intervals of the distinct real roots of a polynomial with integer
+// coefficients in increasing order, found by the Vincent-Collins-Akritas
+// bisection with Descartes' rule of signs; the arithmetic is exact.
+template<class T>
+std::vector<RootInterval> IsolateRealRoots(const Polynomial<T>& polynomial);
+
+// The distinct real roots in increasing order: isolating intervals refined to
+// double precision by Newton's method safeguarded with bisection, with exact
+// signs where rounding hides them. With
+// Execution::Parallel the intervals are refined on the shared ThreadPool.
+template<class T>
+std::vector<double> RealRoots(const Polynomial<T>& polynomial, Execution execution = Execution::Sequential);
+
+#include "Roots.hpp"
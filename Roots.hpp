@@ -0,0 +1,461 @@
+#pragma once
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Arena.hpp"
+#include "BigInt.h"
+#include "CoefficientTraits.h"
+#include "Composition.hpp"
+#include "Gcd.hpp"
+#include "Parallel.hpp"
+
+
+// Evaluates p and p' at z and returns the Newton correction p(z) / p'(z).
+// Outside the unit disk the reversed polynomial is evaluated at 1 / z so
+// that powers of z cannot overflow. Sets converged when |p(z)| is within the
+// rounding error of Horner's scheme.
+template<class T>
+std::complex<T> NewtonCorrection(const T* coefficients, size_t size, const std::complex<T>& z, bool& converged) {
+    typedef std::complex<T> Complex;
+    size_t degree = size - 1;
+    T epsilon = std::numeric_limits<T>::epsilon();
+    bool inside = std::abs(z) <= T(1);
+    Complex point = inside ? z : T(1) / z;
+    T radius = std::abs(point);
+
+    Complex value = inside ? coefficients[degree] : coefficients[0];
+    Complex derivative = T();
+    T bound = std::abs(value);
+    for (size_t step = 1; step <= degree; ++step) {
+        T coef = inside ? coefficients[degree - step] : coefficients[step];
+        derivative = derivative * point + value;
+        value = value * point + coef;
+        bound = bound * radius + std::abs(coef);
+    }
+
+    converged = std::abs(value) <= T(4 * degree) * epsilon * bound;
+    if (value == Complex()) {
+        return Complex();
+    }
+    if (inside) {
+        return derivative == Complex() ? Complex(epsilon * bound) : value / derivative;
+    }
+    return z / (T(static_cast<int>(degree)) - point * derivative / value);
+}
+
+// Aberth-Ehrlich: every approximation z_k moves by the Newton correction N
+// damped by the others, N / (1 - N sum 1 / (z_k - z_j)). Updates are applied
+// in place, so later roots of the sweep already see them; the reciprocals in
+// the sum avoid the general complex division, which dominates the sweep. Starting points lie
+// on a circle around the centroid of the roots whose radius is their
+// geometric mean modulus; a wider circle stalls the iteration for high degrees.
+template<class T>
+void AberthRoots(const T* coefficients, size_t size, std::complex<T>* roots) {
+    typedef std::complex<T> Complex;
+    size_t degree = size - 1;
+    Complex centroid = -coefficients[degree - 1] / (T(static_cast<int>(degree)) * coefficients[degree]);
+    T radius = std::pow(std::abs(coefficients[0] / coefficients[degree]), T(1) / degree);
+    constexpr double pi = 3.14159265358979323846;
+    for (size_t index = 0; index < degree; ++index) {
+        roots[index] = centroid + std::polar(radius, T(2 * pi) * index / degree + T(0.7));
+    }
+
+    ArenaVector<char> converged(degree, 0);
+    size_t remaining = degree;
+    for (size_t iteration = 0; iteration < RootThresholds::aberth_iterations && remaining > 0; ++iteration) {
+        for (size_t index = 0; index < degree; ++index) {
+            if (converged[index]) {
+                continue;
+            }
+            bool done = false;
+            Complex correction = NewtonCorrection(coefficients, size, roots[index], done);
+            Complex repulsion = T();
+            for (size_t other = 0; other < degree; ++other) {
+                if (other != index) {
+                    Complex difference = roots[index] - roots[other];
+                    repulsion += std::conj(difference) / std::norm(difference);
+                }
+            }
+            roots[index] -= correction / (T(1) - correction * repulsion);
+            if (done) {
+                converged[index] = 1;
+                --remaining;
+            }
+        }
+    }
+}
+
+template<class W>
+BigInt ToBigInt(const W& value) {
+    if constexpr (std::is_same<W, BigInt>::value) {
+        return value;
+    } else if constexpr (std::numeric_limits<W>::digits <= std::numeric_limits<long long>::digits) {
+        return BigInt(static_cast<long long>(value));
+    } else {
+        const long long radix = 1LL << 40;
+        ArenaVector<long long> digits;
+        for (W rest = value; rest != W(); rest /= W(radix)) {
+            digits.push_back(static_cast<long long>(rest % W(radix)));
+        }
+        BigInt result;
+        for (size_t index = digits.size(); index-- > 0;) {
+            result = result * BigInt(radix) + BigInt(digits[index]);
+        }
+        return result;
+    }
+}
+
+// Exact ring for root isolation: built-in integers are widened to BigInt,
+// since every bisection step scales the coefficients by up to 2^degree and
+// the remainder sequence of the square-free part grows them further still.
+template<class T, bool = std::is_integral<T>::value>
+struct IsolationRing {
+    typedef T type;
+};
+
+template<class T>
+struct IsolationRing<T, true> {
+    typedef BigInt type;
+};
+
+// Exact quotient of coefficient vectors through Polynomial::RawDivide.
+template<class W>
+ArenaVector<W> DeflateCoefficients(const ArenaVector<W>& dividend, const ArenaVector<W>& divisor) {
+    Polynomial<W> quotient, remainder;
+    Polynomial<W>(dividend.rbegin(), dividend.rend()).RawDivide(Polynomial<W>(divisor.rbegin(), divisor.rend()),
+                                                               quotient, remainder);
+    return ArenaVector<W>(quotient.begin(), quotient.begin() + quotient.Degree() + 1);
+}
+
+template<class W>
+size_t SignVariations(const ArenaVector<W>& coefficients) {
+    size_t variations = 0;
+    int previous = 0;
+    for (size_t index = 0; index < coefficients.size(); ++index) {
+        int sign = coefficients[index] < W() ? -1 : (W() < coefficients[index] ? 1 : 0);
+        if (sign != 0) {
+            variations += previous != 0 && sign != previous;
+            previous = sign;
+        }
+    }
+    return variations;
+}
+
+// Root of the polynomial on (0, 1) or an isolating interval of one, as
+// numerator / 2^depth and (numerator + 1) / 2^depth.
+struct UnitInterval {
+    unsigned long long numerator;
+    int depth;
+    bool exact;
+};
+
+// Descartes' rule on (x + 1)^n q(1 / (x + 1)) bounds the roots of q in (0, 1);
+// at most one means the interval is isolating. Otherwise q is split into
+// 2^n q(x / 2) and 2^n q((x + 1) / 2) for the two halves.
+template<class W>
+void IsolateUnitInterval(const ArenaVector<W>& square_free, std::vector<UnitInterval>& intervals) {
+    struct Task {
+        ArenaVector<W> coefficients;
+        unsigned long long numerator;
+        int depth;
+    };
+    std::vector<Task> tasks(1, Task{square_free, 0, 0});
+    while (!tasks.empty()) {
+        Task task = std::move(tasks.back());
+        tasks.pop_back();
+        ArenaVector<W>& coefficients = task.coefficients;
+        if (coefficients[0] == W()) {
+            intervals.push_back(UnitInterval{task.numerator, task.depth, true});
+            coefficients.erase(coefficients.begin());
+        }
+        size_t degree = coefficients.size() - 1;
+        if (degree == 0) {
+            continue;
+        }
+
+        ArenaVector<W> test(coefficients.rbegin(), coefficients.rend());
+        TaylorShiftCoefficients(test, W(1));
+        size_t variations = SignVariations(test);
+        if (variations == 0) {
+            continue;
+        }
+        if (variations == 1) {
+            intervals.push_back(UnitInterval{task.numerator, task.depth, false});
+            continue;
+        }
+        if (task.depth >= std::numeric_limits<long long>::digits - 1) {
+            throw std::overflow_error("Roots too close for exact root isolation");
+        }
+
+        W scale = W(1);
+        for (size_t index = degree + 1; index-- > 0;) {
+            coefficients[index] *= scale;
+            scale *= W(2);
+        }
+        MakePrimitive(coefficients);
+        ArenaVector<W> right(coefficients);
+        TaylorShiftCoefficients(right, W(1));
+        MakePrimitive(right);
+        tasks.push_back(Task{std::move(right), 2 * task.numerator + 1, task.depth + 1});
+        tasks.push_back(Task{std::move(coefficients), 2 * task.numerator, task.depth + 1});
+    }
+}
+
+// Isolating intervals of the positive roots of a square-free polynomial with
+// nonzero constant term: (0, 1) directly, 1 by the sum of coefficients and
+// (1, bound) through the reversed polynomial, whose roots are the reciprocals.
+template<class W>
+void IsolatePositiveRoots(ArenaVector<W> coefficients, double bound, std::vector<RootInterval>& roots) {
+    W sum = W();
+    for (size_t index = 0; index < coefficients.size(); ++index) {
+        sum += coefficients[index];
+    }
+    if (sum == W()) {
+        roots.push_back(RootInterval{1, 1});
+        ArenaVector<W> linear(2, W(1));
+        linear[0] = W(-1);
+        coefficients = DeflateCoefficients(coefficients, linear);
+    }
+
+    std::vector<UnitInterval> intervals;
+    IsolateUnitInterval(coefficients, intervals);
+    for (const UnitInterval& interval : intervals) {
+        double lower = std::ldexp(static_cast<double>(interval.numerator), -interval.depth);
+        double upper = interval.exact ? lower : std::ldexp(static_cast<double>(interval.numerator + 1), -interval.depth);
+        roots.push_back(RootInterval{lower, upper});
+    }
+
+    intervals.clear();
+    IsolateUnitInterval(ArenaVector<W>(coefficients.rbegin(), coefficients.rend()), intervals);
+    for (const UnitInterval& interval : intervals) {
+        double upper = interval.numerator == 0
+            ? bound : std::ldexp(1.0 / static_cast<double>(interval.numerator), interval.depth);
+        double lower = interval.exact ? upper : std::ldexp(1.0 / static_cast<double>(interval.numerator + 1), interval.depth);
+        roots.push_back(RootInterval{lower, upper});
+    }
+}
+
+template<class T>
+ArenaVector<typename IsolationRing<T>::type> IsolateRealRootsCoefficients(const Polynomial<T>& polynomial,
+                                                                          std::vector<RootInterval>& roots) {
+    static_assert(CoefficientTraits<T>::is_exact && !CoefficientTraits<T>::is_field,
+                  "real root isolation needs exact ordered coefficients such as integers");
+    typedef typename IsolationRing<T>::type W;
+
+    ArenaVector<W> coefficients;
+    for (typename Polynomial<T>::const_iterator iter = polynomial.begin(); iter != polynomial.end() + 1; ++iter) {
+        if constexpr (std::is_same<W, BigInt>::value) {
+            coefficients.push_back(ToBigInt(*iter));
+        } else {
+            coefficients.push_back(static_cast<W>(*iter));
+        }
+    }
+    if (IsZeroCoefficients(coefficients)) {
+        throw std::invalid_argument("The zero polynomial has no isolated roots");
+    }
+
+    if (coefficients.size() > 1) {
+        ArenaVector<W> derivative(coefficients.size() - 1);
+        for (size_t index = 1; index < coefficients.size(); ++index) {
+            derivative[index - 1] = coefficients[index] * W(static_cast<int>(index));
+        }
+        ArenaVector<W> gcd;
+        if constexpr (CoefficientAlgorithms<W>::has_gcd) {
+            gcd = CoefficientAlgorithms<W>::Gcd(coefficients, derivative);
+        } else {
+            gcd = PrimitiveGcd(coefficients, derivative);
+        }
+        if (gcd.size() > 1) {
+            coefficients = DeflateCoefficients(coefficients, gcd);
+        }
+        MakePrimitive(coefficients);
+    }
+
+    if (coefficients[0] == W()) {
+        roots.push_back(RootInterval{0, 0});
+        coefficients.erase(coefficients.begin());
+    }
+
+    double bound = 0;
+    for (size_t index = 0; index + 1 < coefficients.size(); ++index) {
+        bound = std::max(bound, std::abs(static_cast<double>(coefficients[index])));
+    }
+    bound = 1 + bound / std::abs(static_cast<double>(coefficients.back()));
+
+    ArenaVector<W> reflected(coefficients);
+    for (size_t index = 1; index < reflected.size(); index += 2) {
+        reflected[index] = W() - reflected[index];
+    }
+    std::vector<RootInterval> negative;
+    IsolatePositiveRoots(coefficients, bound, roots);
+    IsolatePositiveRoots(reflected, bound, negative);
+    for (const RootInterval& interval : negative) {
+        roots.push_back(RootInterval{-interval.upper, -interval.lower});
+    }
+    std::sort(roots.begin(), roots.end(), [](const RootInterval& lhs, const RootInterval& rhs) {
+        return lhs.lower < rhs.lower || (lhs.lower == rhs.lower && lhs.upper < rhs.upper);
+    });
+    return coefficients;
+}
+
+// Returns p'(point) and sets value to p(point) and bound to the rounding error
+// of Horner's scheme for it.
+inline double HornerDerivative(const double* coefficients, size_t size, double point, double& value, double& bound) {
+    value = coefficients[size - 1];
+    bound = std::abs(value);
+    double derivative = 0;
+    for (size_t index = size - 1; index-- > 0;) {
+        derivative = derivative * point + value;
+        value = value * point + coefficients[index];
+        bound = bound * std::abs(point) + std::abs(coefficients[index]);
+    }
+    bound *= 4 * size * std::numeric_limits<double>::epsilon();
+    return derivative;
+}
+
+// Sign of p at a double, computed exactly: the point is m 2^e with an integer
+// m, and for e < 0 the integer sum of a_i m^i 2^(-e (n - i)) has the sign of
+// p(m 2^e).
+inline int ExactSign(const ArenaVector<BigInt>& coefficients, double point) {
+    int exponent;
+    long long numerator = static_cast<long long>(std::ldexp(std::frexp(point, &exponent), 53));
+    exponent -= 53;
+    while (numerator != 0 && numerator % 2 == 0) {
+        numerator /= 2;
+        ++exponent;
+    }
+    BigInt power(1);
+    for (int bits = std::abs(exponent); bits > 0; bits -= 30) {
+        power.MultiplyAdd(1u << std::min(bits, 30), 0);
+    }
+
+    BigInt value = coefficients.back();
+    if (exponent >= 0) {
+        BigInt x = BigInt(numerator) * power;
+        for (size_t index = coefficients.size() - 1; index-- > 0;) {
+            value = value * x + coefficients[index];
+        }
+    } else {
+        BigInt scale(1);
+        for (size_t index = coefficients.size() - 1; index-- > 0;) {
+            scale *= power;
+            value = value * BigInt(numerator) + coefficients[index] * scale;
+        }
+    }
+    return value.IsZero() ? 0 : (value.IsNegative() ? -1 : 1);
+}
+
+// Newton's method kept inside the bracket: a step that leaves it is replaced
+// by bisection, and the bracket shrinks with every evaluation. Where |p| is
+// within the rounding error of the double evaluation, its sign is taken from
+// the exact coefficients and the step is a bisection. The endpoints may be
+// roots themselves, then the sign right of lower is that of p'(lower).
+inline double RefineRoot(const double* coefficients, size_t size, const ArenaVector<BigInt>& exact,
+                         double lower, double upper) {
+    if (lower == upper) {
+        return lower;
+    }
+    auto sign = [&](double point, double& value, double& derivative) {
+        double bound;
+        derivative = HornerDerivative(coefficients, size, point, value, bound);
+        if (std::abs(value) > bound) {
+            return value < 0 ? -1 : 1;
+        }
+        derivative = 0;
+        return ExactSign(exact, point);
+    };
+
+    double value;
+    double derivative;
+    int lower_sign = sign(lower, value, derivative);
+    if (lower_sign == 0) {
+        lower_sign = -sign(upper, value, derivative);
+    }
+    if (lower_sign == 0) {
+        double bound;
+        lower_sign = HornerDerivative(coefficients, size, lower, value, bound) < 0 ? -1 : 1;
+    }
+
+    double point = lower + (upper - lower) / 2;
+    for (size_t iteration = 0; iteration < RootThresholds::refine_iterations; ++iteration) {
+        int point_sign = sign(point, value, derivative);
+        if (point_sign == 0) {
+            return point;
+        }
+        if (point_sign == lower_sign) {
+            lower = point;
+        } else {
+            upper = point;
+        }
+
+        double next = derivative != 0 ? point - value / derivative : lower;
+        if (!(next > lower && next < upper)) {
+            next = lower + (upper - lower) / 2;
+        }
+        if (std::abs(next - point) <= 2 * std::numeric_limits<double>::epsilon() * std::abs(next)
+            || next == lower || next == upper) {
+            return next;
+        }
+        point = next;
+    }
+    return point;
+}
+
+template<class T>
+std::vector<std::complex<T> > ComplexRoots(const Polynomial<T>& polynomial) {
+    static_assert(std::is_floating_point<T>::value, "complex roots need floating point coefficients");
+    const T* coefficients = &*polynomial.begin();
+    size_t size = polynomial.Degree() + 1;
+    if (size == 1 && coefficients[0] == T()) {
+        throw std::invalid_argument("Every number is a root of the zero polynomial");
+    }
+
+    size_t zeros = 0;
+    while (coefficients[zeros] == T()) {
+        ++zeros;
+    }
+    std::vector<std::complex<T> > roots(size - 1);
+    if (size - zeros > 1) {
+        AberthRoots(coefficients + zeros, size - zeros, &roots[zeros]);
+    }
+    std::sort(roots.begin(), roots.end(), [](const std::complex<T>& lhs, const std::complex<T>& rhs) {
+        return lhs.real() < rhs.real() || (lhs.real() == rhs.real() && lhs.imag() < rhs.imag());
+    });
+    return roots;
+}
+
+template<class T>
+std::vector<RootInterval> IsolateRealRoots(const Polynomial<T>& polynomial) {
+    std::vector<RootInterval> roots;
+    IsolateRealRootsCoefficients(polynomial, roots);
+    return roots;
+}
+
+template<class T>
+std::vector<double> RealRoots(const Polynomial<T>& polynomial, Execution execution) {
+    std::vector<RootInterval> intervals;
+    ArenaVector<typename IsolationRing<T>::type> square_free = IsolateRealRootsCoefficients(polynomial, intervals);
+    std::vector<double> coefficients(square_free.begin(), square_free.end());
+    ArenaVector<BigInt> exact;
+    for (size_t index = 0; index < square_free.size(); ++index) {
+        exact.push_back(ToBigInt(square_free[index]));
+    }
+    std::vector<double> roots(intervals.size());
+    auto refine = [&](size_t index) {
+        roots[index] = RefineRoot(&coefficients[0], coefficients.size(), exact, intervals[index].lower, intervals[index].upper);
+    };
+    if (execution == Execution::Parallel && intervals.size() >= RootThresholds::parallel_refine) {
+        ThreadPool::Shared().ParallelFor(intervals.size(), refine);
+    } else {
+        for (size_t index = 0; index < intervals.size(); ++index) {
+            refine(index);
+        }
+    }
+    return roots;
+}
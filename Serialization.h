@@ -0,0 +1,120 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+#include "Polynomial.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define POLYNOMIAL_HAS_MMAP 1
+#endif
+
+
+// Binary layout: a 16-byte SerializedHeader followed by the degree + 1
+// coefficients, lowest power first, as raw bytes in the byte order named by
+// the header. Writers always use the byte order of the machine; readers swap
+// when it differs.
+enum class SerializedType : unsigned char {
+    SignedInteger = 1,
+    UnsignedInteger = 2,
+    FloatingPoint = 3
+};
+
+struct SerializedHeader {
+    char magic[4];
+    unsigned char version;
+    unsigned char type;
+    unsigned char endianness;
+    unsigned char coefficient_size;
+    unsigned long long degree;
+};
+
+static_assert(sizeof(SerializedHeader) == 16, "the payload starts at byte 16");
+
+template<class T>
+SerializedType SerializedTypeOf();
+
+// Writes a polynomial whose coefficients arrive in pieces, so a huge one never
+// has to be held in memory. The degree is fixed up front and exactly
+// degree + 1 coefficients must be written before Finish().
+template<class T>
+class PolynomialWriter {
+private:
+    std::ostream& stream;
+    unsigned long long remaining;
+
+public:
+    PolynomialWriter(std::ostream& stream, size_t degree);
+
+    void Write(const T* coefficients, size_t count);
+
+    void Finish();
+};
+
+// Reads the header on construction and then hands out the coefficients in
+// chunks of any size.
+template<class T>
+class PolynomialReader {
+private:
+    std::istream& stream;
+    SerializedHeader header;
+    unsigned long long remaining;
+
+public:
+    explicit PolynomialReader(std::istream& stream);
+
+    int Degree() const;
+
+    size_t Remaining() const;
+
+    size_t Read(T* coefficients, size_t count);
+
+    Polynomial<T> ReadAll();
+};
+
+#ifdef POLYNOMIAL_HAS_MMAP
+// Read-only view of a file written by WritePolynomial, mapped into memory.
+// Coefficients and evaluation work directly on the mapping; nothing is copied
+// until ToPolynomial(). The file must use the byte order of the machine.
+// Requires POSIX mmap, so it is only declared where POLYNOMIAL_HAS_MMAP is.
+template<class T>
+class PolynomialView {
+private:
+    void* mapping;
+    size_t length;
+    const T* coefficients;
+    int degree;
+
+public:
+    explicit PolynomialView(const std::string& path);
+
+    ~PolynomialView();
+
+    PolynomialView(const PolynomialView&) = delete;
+    PolynomialView& operator =(const PolynomialView&) = delete;
+
+    int Degree() const;
+
+    const T& operator[](size_t) const;
+
+    T operator()(const T&) const;
+
+    void Evaluate(const T* points, size_t count, T* values,
+                  Execution execution = Execution::Sequential) const;
+
+    const T* begin() const;
+    const T* end() const;
+
+    Polynomial<T> ToPolynomial() const;
+};
+#endif
+
+template<class T>
+void WritePolynomial(std::ostream&, const Polynomial<T>&);
+
+template<class T>
+Polynomial<T> ReadPolynomial(std::istream&);
+
+#include "Serialization.hpp"
@@ -0,0 +1,240 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef POLYNOMIAL_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static const char kSerializedMagic[4] = {'P', 'O', 'L', 'Y'};
+static const unsigned char kSerializedVersion = 1;
+
+static const unsigned char kLittleEndian = 1;
+static const unsigned char kBigEndian = 2;
+
+// Coefficients ReadAll reads before it trusts the header with a larger buffer.
+static const size_t kSerializedChunk = 4096;
+
+inline unsigned char NativeEndianness() {
+    const unsigned short probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1 ? kLittleEndian : kBigEndian;
+}
+
+template<class T>
+void ReverseBytes(T* values, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(values + index);
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+}
+
+template<class T>
+SerializedType SerializedTypeOf() {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "only integer and floating point coefficients can be serialized");
+    if (std::is_floating_point<T>::value) {
+        return SerializedType::FloatingPoint;
+    }
+    return std::is_signed<T>::value ? SerializedType::SignedInteger : SerializedType::UnsignedInteger;
+}
+
+// Throws unless the header describes a polynomial with coefficients of type T.
+template<class T>
+void CheckHeader(const SerializedHeader& header) {
+    if (std::memcmp(header.magic, kSerializedMagic, sizeof(kSerializedMagic)) != 0
+        || header.version != kSerializedVersion
+        || (header.endianness != kLittleEndian && header.endianness != kBigEndian)) {
+        throw std::invalid_argument("Not a serialized polynomial");
+    }
+    if (header.type != static_cast<unsigned char>(SerializedTypeOf<T>()) || header.coefficient_size != sizeof(T)) {
+        throw std::invalid_argument("Serialized coefficient type does not match");
+    }
+}
+
+template<class T>
+PolynomialWriter<T>::PolynomialWriter(std::ostream& stream, size_t degree)
+    : stream(stream), remaining(degree + 1ull) {
+    SerializedHeader header;
+    std::memcpy(header.magic, kSerializedMagic, sizeof(kSerializedMagic));
+    header.version = kSerializedVersion;
+    header.type = static_cast<unsigned char>(SerializedTypeOf<T>());
+    header.endianness = NativeEndianness();
+    header.coefficient_size = sizeof(T);
+    header.degree = degree;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+template<class T>
+void PolynomialWriter<T>::Write(const T* coefficients, size_t count) {
+    if (count > remaining) {
+        throw std::out_of_range("More coefficients than the degree allows");
+    }
+    stream.write(reinterpret_cast<const char*>(coefficients), count * sizeof(T));
+    remaining -= count;
+}
+
+template<class T>
+void PolynomialWriter<T>::Finish() {
+    if (remaining != 0) {
+        throw std::out_of_range("Fewer coefficients than the degree requires");
+    }
+    if (!stream.flush()) {
+        throw std::runtime_error("Cannot write serialized polynomial");
+    }
+}
+
+template<class T>
+PolynomialReader<T>::PolynomialReader(std::istream& stream) : stream(stream) {
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::invalid_argument("Not a serialized polynomial");
+    }
+    CheckHeader<T>(header);
+    if (header.endianness != NativeEndianness()) {
+        ReverseBytes(&header.degree, 1);
+    }
+    if (header.degree >= static_cast<unsigned long long>(std::numeric_limits<int>::max())) {
+        throw std::invalid_argument("Serialized degree is too large");
+    }
+    remaining = header.degree + 1;
+}
+
+template<class T>
+int PolynomialReader<T>::Degree() const {
+    return static_cast<int>(header.degree);
+}
+
+template<class T>
+size_t PolynomialReader<T>::Remaining() const {
+    return remaining;
+}
+
+template<class T>
+size_t PolynomialReader<T>::Read(T* coefficients, size_t count) {
+    count = std::min<unsigned long long>(count, remaining);
+    if (!stream.read(reinterpret_cast<char*>(coefficients), count * sizeof(T))) {
+        throw std::invalid_argument("Serialized polynomial is truncated");
+    }
+    if (header.endianness != NativeEndianness()) {
+        ReverseBytes(coefficients, count);
+    }
+    remaining -= count;
+    return count;
+}
+
+// The degree in the header is not trusted with the size of the buffer: it
+// grows by at most what has already arrived, so a truncated or hostile file
+// fails on the missing bytes before it can force a large allocation.
+template<class T>
+Polynomial<T> PolynomialReader<T>::ReadAll() {
+    typename Polynomial<T>::Coefficients coefficients;
+    while (remaining > 0) {
+        size_t size = coefficients.size();
+        size_t chunk = std::min<unsigned long long>(remaining, std::max(size, kSerializedChunk));
+        coefficients.resize(size + chunk);
+        Read(&coefficients[size], chunk);
+    }
+    return Polynomial<T>(std::move(coefficients));
+}
+
+#ifdef POLYNOMIAL_HAS_MMAP
+template<class T>
+PolynomialView<T>::PolynomialView(const std::string& path) : mapping(MAP_FAILED), length(0) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat status;
+    if (fstat(file, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(SerializedHeader)) {
+        length = status.st_size;
+        mapping = mmap(0, length, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+
+    try {
+        const SerializedHeader& header = *static_cast<const SerializedHeader*>(mapping);
+        CheckHeader<T>(header);
+        if (header.endianness != NativeEndianness()) {
+            throw std::invalid_argument("Serialized byte order differs from the machine");
+        }
+        if (header.degree >= static_cast<unsigned long long>(std::numeric_limits<int>::max())) {
+            throw std::invalid_argument("Serialized degree is too large");
+        }
+        if (header.degree >= (length - sizeof(SerializedHeader)) / sizeof(T)
+            || length != sizeof(SerializedHeader) + (header.degree + 1) * sizeof(T)) {
+            throw std::invalid_argument("Serialized polynomial is truncated");
+        }
+        degree = static_cast<int>(header.degree);
+        coefficients = reinterpret_cast<const T*>(static_cast<const char*>(mapping) + sizeof(SerializedHeader));
+    } catch (...) {
+        munmap(mapping, length);
+        throw;
+    }
+}
+
+template<class T>
+PolynomialView<T>::~PolynomialView() {
+    munmap(mapping, length);
+}
+
+template<class T>
+int PolynomialView<T>::Degree() const {
+    return degree;
+}
+
+template<class T>
+const T& PolynomialView<T>::operator[](size_t index) const {
+    if (index > static_cast<size_t>(degree)) {
+        throw std::out_of_range("Out of range, object is constant");
+    }
+    return coefficients[index];
+}
+
+template<class T>
+T PolynomialView<T>::operator()(const T& arg) const {
+    return HornerValue(coefficients, degree + 1, arg);
+}
+
+template<class T>
+void PolynomialView<T>::Evaluate(const T* points, size_t count, T* values, Execution execution) const {
+    EvaluateCoefficients(coefficients, degree + 1, points, count, values, execution);
+}
+
+template<class T>
+const T* PolynomialView<T>::begin() const {
+    return coefficients;
+}
+
+template<class T>
+const T* PolynomialView<T>::end() const {
+    return coefficients + degree + 1;
+}
+
+template<class T>
+Polynomial<T> PolynomialView<T>::ToPolynomial() const {
+    return Polynomial<T>(std::make_reverse_iterator(end()), std::make_reverse_iterator(begin()));
+}
+#endif
+
+template<class T>
+void WritePolynomial(std::ostream& stream, const Polynomial<T>& polynomial) {
+    PolynomialWriter<T> writer(stream, polynomial.Degree());
+    writer.Write(&*polynomial.begin(), polynomial.Degree() + 1);
+    writer.Finish();
+}
+
+template<class T>
+Polynomial<T> ReadPolynomial(std::istream& stream) {
+    return PolynomialReader<T>(stream).ReadAll();
+}
@@ -0,0 +1,408 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+
+// Coefficient-wise kernels for double, float and 32/64-bit integers. The loop
+// bodies are written once over GCC vector types and instantiated inside
+// functions compiled for AVX2 and AVX-512; the widest one the CPU supports is
+// picked at run time. Other coefficient types, other compilers and builds with
+// POLYNOMIAL_NO_SIMD use the plain loops.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(POLYNOMIAL_NO_SIMD)
+#define POLYNOMIAL_SIMD_X86 1
+#endif
+
+enum class SimdLevel {
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+inline SimdLevel DetectSimdLevel() {
+#ifdef POLYNOMIAL_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::Avx2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+struct SimdSettings {
+    static inline SimdLevel level = DetectSimdLevel();
+};
+
+template<class T>
+struct IsSimdCoefficient
+    : std::integral_constant<bool, std::is_same<T, double>::value || std::is_same<T, float>::value
+                                   || (std::is_integral<T>::value && !std::is_same<T, bool>::value
+                                       && (sizeof(T) == 4 || sizeof(T) == 8))> {};
+
+// Signed integers wrap modulo 2^W like the multiplication ring does: their
+// kernels run on the unsigned type of the same width, where overflow is
+// defined and which may alias the signed array.
+template<class T, bool = std::is_integral<T>::value && std::is_signed<T>::value>
+struct WrappingKernel {
+    typedef T type;
+};
+
+template<class T>
+struct WrappingKernel<T, true> {
+    typedef typename std::make_unsigned<T>::type type;
+};
+
+template<class T>
+void ScalarAdd(T* lhs, const T* rhs, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+        lhs[index] += rhs[index];
+    }
+}
+
+template<class T>
+void ScalarSubtract(T* lhs, const T* rhs, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+        lhs[index] -= rhs[index];
+    }
+}
+
+template<class T>
+void ScalarScale(T* values, size_t size, const T& factor) {
+    for (size_t index = 0; index < size; ++index) {
+        values[index] *= factor;
+    }
+}
+
+template<class T>
+void ScalarAxpy(T* lhs, const T* rhs, size_t size, const T& factor) {
+    for (size_t index = 0; index < size; ++index) {
+        lhs[index] += factor * rhs[index];
+    }
+}
+
+template<class T>
+void ScalarMultiplyAdd(T* lhs, const T* first, const T* second, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+        lhs[index] += first[index] * second[index];
+    }
+}
+
+template<class T>
+void ScalarMultiplySubtract(T* lhs, const T* first, const T* second, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+        lhs[index] -= first[index] * second[index];
+    }
+}
+
+template<class T>
+void ScalarHornerStep(T* values, const T* points, const T* coefficients, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+        values[index] = values[index] * points[index] + coefficients[index];
+    }
+}
+
+static const size_t kHornerLanes = 8;
+
+// Runs Horner's scheme for kHornerLanes points at once, so the lanes are
+// independent and the compiler is free to interleave them.
+template<class T>
+void ScalarHorner(const T* coefficients, size_t size, const T* points, size_t count, T* values) {
+    size_t point = 0;
+    for (; point + kHornerLanes <= count; point += kHornerLanes) {
+        T lanes[kHornerLanes];
+        for (size_t lane = 0; lane < kHornerLanes; ++lane) {
+            lanes[lane] = coefficients[size - 1];
+        }
+        for (size_t index = size - 1; index-- > 0;) {
+            for (size_t lane = 0; lane < kHornerLanes; ++lane) {
+                lanes[lane] = lanes[lane] * points[point + lane] + coefficients[index];
+            }
+        }
+        for (size_t lane = 0; lane < kHornerLanes; ++lane) {
+            values[point + lane] = lanes[lane];
+        }
+    }
+    for (; point < count; ++point) {
+        T value = coefficients[size - 1];
+        for (size_t index = size - 1; index-- > 0;) {
+            value = value * points[point] + coefficients[index];
+        }
+        values[point] = value;
+    }
+}
+
+#ifdef POLYNOMIAL_SIMD_X86
+
+#define POLYNOMIAL_SIMD_INLINE inline __attribute__((always_inline))
+
+template<class T, size_t Bytes>
+struct VectorKernels {
+    typedef T Vector __attribute__((vector_size(Bytes)));
+    static const size_t width = Bytes / sizeof(T);
+
+    // Vectors are passed by reference only, returning them by value from a
+    // function compiled for the base ISA would change the calling convention.
+    static POLYNOMIAL_SIMD_INLINE void Load(Vector& result, const T* source) {
+        std::memcpy(&result, source, Bytes);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Store(T* target, const Vector& value) {
+        std::memcpy(target, &value, Bytes);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Broadcast(Vector& result, const T& value) {
+        Vector zero = {};
+        result = zero + value;
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Add(T* lhs, const T* rhs, size_t size) {
+        Vector lhs_values = {}, rhs_values = {};
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(lhs_values, lhs + index);
+            Load(rhs_values, rhs + index);
+            Store(lhs + index, lhs_values + rhs_values);
+        }
+        ScalarAdd(lhs + index, rhs + index, size - index);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Subtract(T* lhs, const T* rhs, size_t size) {
+        Vector lhs_values = {}, rhs_values = {};
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(lhs_values, lhs + index);
+            Load(rhs_values, rhs + index);
+            Store(lhs + index, lhs_values - rhs_values);
+        }
+        ScalarSubtract(lhs + index, rhs + index, size - index);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Scale(T* values, size_t size, const T& factor) {
+        Vector factors = {}, current = {};
+        Broadcast(factors, factor);
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(current, values + index);
+            Store(values + index, current * factors);
+        }
+        ScalarScale(values + index, size - index, factor);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void Axpy(T* lhs, const T* rhs, size_t size, const T& factor) {
+        Vector factors = {}, lhs_values = {}, rhs_values = {};
+        Broadcast(factors, factor);
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(lhs_values, lhs + index);
+            Load(rhs_values, rhs + index);
+            Store(lhs + index, lhs_values + factors * rhs_values);
+        }
+        ScalarAxpy(lhs + index, rhs + index, size - index, factor);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void MultiplyAdd(T* lhs, const T* first, const T* second, size_t size) {
+        Vector lhs_values = {}, first_values = {}, second_values = {};
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(lhs_values, lhs + index);
+            Load(first_values, first + index);
+            Load(second_values, second + index);
+            Store(lhs + index, lhs_values + first_values * second_values);
+        }
+        ScalarMultiplyAdd(lhs + index, first + index, second + index, size - index);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void MultiplySubtract(T* lhs, const T* first, const T* second, size_t size) {
+        Vector lhs_values = {}, first_values = {}, second_values = {};
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(lhs_values, lhs + index);
+            Load(first_values, first + index);
+            Load(second_values, second + index);
+            Store(lhs + index, lhs_values - first_values * second_values);
+        }
+        ScalarMultiplySubtract(lhs + index, first + index, second + index, size - index);
+    }
+
+    static POLYNOMIAL_SIMD_INLINE void HornerStep(T* values, const T* points, const T* coefficients, size_t size) {
+        Vector current = {}, point_values = {}, coefficient_values = {};
+        size_t index = 0;
+        for (; index + width <= size; index += width) {
+            Load(current, values + index);
+            Load(point_values, points + index);
+            Load(coefficient_values, coefficients + index);
+            Store(values + index, current * point_values + coefficient_values);
+        }
+        ScalarHornerStep(values + index, points + index, coefficients + index, size - index);
+    }
+
+    // Two independent vectors of points per iteration hide the latency of
+    // the multiply-add chain.
+    static POLYNOMIAL_SIMD_INLINE void Horner(const T* coefficients, size_t size,
+                                              const T* points, size_t count, T* values) {
+        Vector first_points = {}, second_points = {}, first = {}, second = {}, coefficient = {};
+        size_t point = 0;
+        for (; point + 2 * width <= count; point += 2 * width) {
+            Load(first_points, points + point);
+            Load(second_points, points + point + width);
+            Broadcast(first, coefficients[size - 1]);
+            second = first;
+            for (size_t index = size - 1; index-- > 0;) {
+                Broadcast(coefficient, coefficients[index]);
+                first = first * first_points + coefficient;
+                second = second * second_points + coefficient;
+            }
+            Store(values + point, first);
+            Store(values + point + width, second);
+        }
+        ScalarHorner(coefficients, size, points + point, count - point, values + point);
+    }
+};
+
+#define POLYNOMIAL_SIMD_TARGETS(Name, Parameters, Arguments)                                        \
+    template<class T>                                                                              \
+    __attribute__((target("avx2,fma"))) void Name##Avx2 Parameters {                               \
+        VectorKernels<T, 32>::Name Arguments;                                                      \
+    }                                                                                              \
+    template<class T>                                                                              \
+    __attribute__((target("avx512f"))) void Name##Avx512 Parameters {                              \
+        VectorKernels<T, 64>::Name Arguments;                                                      \
+    }
+
+POLYNOMIAL_SIMD_TARGETS(Add, (T* lhs, const T* rhs, size_t size), (lhs, rhs, size))
+POLYNOMIAL_SIMD_TARGETS(Subtract, (T* lhs, const T* rhs, size_t size), (lhs, rhs, size))
+POLYNOMIAL_SIMD_TARGETS(Scale, (T* values, size_t size, const T& factor), (values, size, factor))
+POLYNOMIAL_SIMD_TARGETS(Axpy, (T* lhs, const T* rhs, size_t size, const T& factor), (lhs, rhs, size, factor))
+POLYNOMIAL_SIMD_TARGETS(MultiplyAdd, (T* lhs, const T* first, const T* second, size_t size),
+                        (lhs, first, second, size))
+POLYNOMIAL_SIMD_TARGETS(MultiplySubtract, (T* lhs, const T* first, const T* second, size_t size),
+                        (lhs, first, second, size))
+POLYNOMIAL_SIMD_TARGETS(HornerStep, (T* values, const T* points, const T* coefficients, size_t size),
+                        (values, points, coefficients, size))
+POLYNOMIAL_SIMD_TARGETS(Horner, (const T* coefficients, size_t size, const T* points, size_t count, T* values),
+                        (coefficients, size, points, count, values))
+
+#undef POLYNOMIAL_SIMD_TARGETS
+
+#define POLYNOMIAL_SIMD_DISPATCH(Name, Arguments)                                                   \
+    if constexpr (IsSimdCoefficient<T>::value) {                                                   \
+        if (SimdSettings::level == SimdLevel::Avx512) {                                            \
+            Name##Avx512 Arguments;                                                                \
+            return;                                                                                \
+        }                                                                                          \
+        if (SimdSettings::level == SimdLevel::Avx2) {                                              \
+            Name##Avx2 Arguments;                                                                  \
+            return;                                                                                \
+        }                                                                                          \
+    }
+
+#else
+
+#define POLYNOMIAL_SIMD_DISPATCH(Name, Arguments)
+
+#endif
+
+// lhs[i] += rhs[i]; lhs and rhs may be the same array.
+template<class T>
+void AddCoefficients(T* lhs, const T* rhs, size_t size) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        AddCoefficients(reinterpret_cast<U*>(lhs), reinterpret_cast<const U*>(rhs), size);
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(Add, <T>(lhs, rhs, size))
+        ScalarAdd(lhs, rhs, size);
+    }
+}
+
+template<class T>
+void SubtractCoefficients(T* lhs, const T* rhs, size_t size) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        SubtractCoefficients(reinterpret_cast<U*>(lhs), reinterpret_cast<const U*>(rhs), size);
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(Subtract, <T>(lhs, rhs, size))
+        ScalarSubtract(lhs, rhs, size);
+    }
+}
+
+template<class T>
+void ScaleCoefficients(T* values, size_t size, const T& factor) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        ScaleCoefficients(reinterpret_cast<U*>(values), size, static_cast<U>(factor));
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(Scale, <T>(values, size, factor))
+        ScalarScale(values, size, factor);
+    }
+}
+
+// lhs[i] += factor * rhs[i]; lhs and rhs may be the same array.
+template<class T>
+void AxpyCoefficients(T* lhs, const T* rhs, size_t size, const T& factor) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        AxpyCoefficients(reinterpret_cast<U*>(lhs), reinterpret_cast<const U*>(rhs), size, static_cast<U>(factor));
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(Axpy, <T>(lhs, rhs, size, factor))
+        ScalarAxpy(lhs, rhs, size, factor);
+    }
+}
+
+// The element-wise kernels below work on one coefficient of many polynomials
+// at once, as stored by PolynomialBatch.
+
+// lhs[i] += first[i] * second[i].
+template<class T>
+void MultiplyAddCoefficients(T* lhs, const T* first, const T* second, size_t size) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        MultiplyAddCoefficients(reinterpret_cast<U*>(lhs), reinterpret_cast<const U*>(first),
+                                reinterpret_cast<const U*>(second), size);
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(MultiplyAdd, <T>(lhs, first, second, size))
+        ScalarMultiplyAdd(lhs, first, second, size);
+    }
+}
+
+// lhs[i] -= first[i] * second[i].
+template<class T>
+void MultiplySubtractCoefficients(T* lhs, const T* first, const T* second, size_t size) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        MultiplySubtractCoefficients(reinterpret_cast<U*>(lhs), reinterpret_cast<const U*>(first),
+                                     reinterpret_cast<const U*>(second), size);
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(MultiplySubtract, <T>(lhs, first, second, size))
+        ScalarMultiplySubtract(lhs, first, second, size);
+    }
+}
+
+// values[i] = values[i] * points[i] + coefficients[i].
+template<class T>
+void HornerStepCoefficients(T* values, const T* points, const T* coefficients, size_t size) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        HornerStepCoefficients(reinterpret_cast<U*>(values), reinterpret_cast<const U*>(points),
+                               reinterpret_cast<const U*>(coefficients), size);
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(HornerStep, <T>(values, points, coefficients, size))
+        ScalarHornerStep(values, points, coefficients, size);
+    }
+}
+
+template<class T>
+void HornerCoefficients(const T* coefficients, size_t size, const T* points, size_t count, T* values) {
+    typedef typename WrappingKernel<T>::type U;
+    if constexpr (!std::is_same<U, T>::value) {
+        HornerCoefficients(reinterpret_cast<const U*>(coefficients), size,
+                           reinterpret_cast<const U*>(points), count, reinterpret_cast<U*>(values));
+    } else {
+        POLYNOMIAL_SIMD_DISPATCH(Horner, <T>(coefficients, size, points, count, values))
+        ScalarHorner(coefficients, size, points, count, values);
+    }
+}
+
+#undef POLYNOMIAL_SIMD_DISPATCH
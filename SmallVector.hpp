@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Arena.hpp"
+
+
+// Vector that keeps up to N elements inside the object and moves them to
+// memory from an ArenaAllocator once it grows past that. Only the part of the
+// std::vector interface the polynomial code uses is provided; iterators are
+// plain pointers. Like ArenaVector, a moved-to vector takes the buffer of the
+// source only when both use the same resource.
+template<class T, size_t N>
+class SmallVector {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+private:
+    T* items;
+    size_t count;
+    size_t reserved;
+    ArenaAllocator<T> allocator;
+    alignas(T) unsigned char storage[N * sizeof(T)];
+
+    T* InlineItems() {
+        return reinterpret_cast<T*>(storage);
+    }
+
+    bool IsInline() const {
+        return items == reinterpret_cast<const T*>(storage);
+    }
+
+    void Free() {
+        if (!IsInline()) {
+            allocator.deallocate(items, reserved);
+            items = InlineItems();
+            reserved = N;
+        }
+    }
+
+    void Reallocate(size_t capacity) {
+        T* buffer = allocator.allocate(capacity);
+        CountStat(StatCounter::CopiedBytes, count * sizeof(T));
+        std::uninitialized_move(items, items + count, buffer);
+        std::destroy(items, items + count);
+        Free();
+        items = buffer;
+        reserved = capacity;
+    }
+
+    void Steal(SmallVector& other) {
+        items = other.items;
+        count = other.count;
+        reserved = other.reserved;
+        other.items = other.InlineItems();
+        other.count = 0;
+        other.reserved = N;
+    }
+
+public:
+    SmallVector() : items(InlineItems()), count(0), reserved(N) {}
+
+    explicit SmallVector(size_t size) : SmallVector() {
+        resize(size);
+    }
+
+    template<class Iter, class = typename std::enable_if<!std::is_integral<Iter>::value>::type>
+    SmallVector(Iter first, Iter last) : SmallVector() {
+        assign(first, last);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        CountStat(StatCounter::CopiedBytes, other.count * sizeof(T));
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept
+        : items(InlineItems()), count(0), reserved(N), allocator(other.allocator) {
+        if (!other.IsInline()) {
+            Steal(other);
+            return;
+        }
+        std::uninitialized_move(other.items, other.items + other.count, items);
+        count = other.count;
+        other.clear();
+    }
+
+    ~SmallVector() {
+        clear();
+        Free();
+    }
+
+    SmallVector& operator =(const SmallVector& other) {
+        if (this != &other) {
+            CountStat(StatCounter::CopiedBytes, other.count * sizeof(T));
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator =(SmallVector&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (!other.IsInline() && allocator == other.allocator) {
+            clear();
+            Free();
+            Steal(other);
+            return *this;
+        }
+        assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        other.clear();
+        return *this;
+    }
+
+    template<class Iter, class = typename std::enable_if<!std::is_integral<Iter>::value>::type>
+    void assign(Iter first, Iter last) {
+        clear();
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) {
+            new (items + count) T(*first);
+            ++count;
+        }
+    }
+
+    void assign(size_t size, const T& value) {
+        T copy(value);
+        clear();
+        reserve(size);
+        std::uninitialized_fill_n(items, size, copy);
+        count = size;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > reserved) {
+            Reallocate(capacity);
+        }
+    }
+
+    void resize(size_t size) {
+        if (size < count) {
+            std::destroy(items + size, items + count);
+        } else if (size > count) {
+            reserve(std::max(size, 2 * count));
+            std::uninitialized_value_construct(items + count, items + size);
+        }
+        count = size;
+    }
+
+    void push_back(const T& value) {
+        if (count == reserved) {
+            T copy(value);
+            Reallocate(2 * reserved);
+            new (items + count) T(std::move(copy));
+        } else {
+            new (items + count) T(value);
+        }
+        ++count;
+    }
+
+    void pop_back() {
+        --count;
+        items[count].~T();
+    }
+
+    // Inserts size copies of value before position, moving the tail back.
+    void insert(const_iterator position, size_t size, const T& value) {
+        T copy(value);
+        size_t offset = position - items;
+        resize(count + size);
+        std::move_backward(items + offset, items + count - size, items + count);
+        std::fill(items + offset, items + offset + size, copy);
+    }
+
+    void clear() {
+        std::destroy(items, items + count);
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t capacity() const {
+        return reserved;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    T& operator[](size_t index) {
+        return items[index];
+    }
+
+    const T& operator[](size_t index) const {
+        return items[index];
+    }
+
+    T& back() {
+        return items[count - 1];
+    }
+
+    const T& back() const {
+        return items[count - 1];
+    }
+
+    iterator begin() {
+        return items;
+    }
+
+    iterator end() {
+        return items + count;
+    }
+
+    const_iterator begin() const {
+        return items;
+    }
+
+    const_iterator end() const {
+        return items + count;
+    }
+
+    friend bool operator ==(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return lhs.count == rhs.count && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator !=(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator <(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <utility>
+
+#include "Polynomial.h"
+
+
+enum class Representation {
+    Dense,
+    Sparse
+};
+
+struct SparseThresholds {
+    // A polynomial with fewer than fill_ratio * (degree + 1) nonzero terms is
+    // stored sparsely; denser operands are multiplied in dense form.
+    static inline double fill_ratio = 0.1;
+};
+
+inline Representation ChooseRepresentation(size_t terms, size_t degree) {
+    return terms < SparseThresholds::fill_ratio * (degree + 1) ? Representation::Sparse : Representation::Dense;
+}
+
+// Polynomial stored as (exponent, coefficient) pairs sorted by exponent with
+// no zero coefficients, so x^1000000 + 1 takes two terms. The zero polynomial
+// has no terms.
+template<class T>
+class SparsePolynomial {
+public:
+    typedef std::pair<size_t, T> Term;
+
+private:
+    std::vector<Term> terms;
+
+    void Normalize();
+
+    static std::vector<Term> Product(const SparsePolynomial<T>& lhs, const SparsePolynomial<T>& rhs);
+
+    void DivideInPlace(const SparsePolynomial<T>& rhs, std::vector<Term>& quotient);
+
+public:
+    typedef T value_type;
+
+    SparsePolynomial(const T& coef = T());
+
+    explicit SparsePolynomial(std::vector<Term> terms);
+
+    explicit SparsePolynomial(const Polynomial<T>& dense);
+
+    Polynomial<T> ToDense() const;
+
+    bool operator ==(const SparsePolynomial<T>&) const;
+    bool operator !=(const SparsePolynomial<T>&) const;
+
+    SparsePolynomial<T>& operator +=(const SparsePolynomial<T>&);
+    SparsePolynomial<T>& operator -=(const SparsePolynomial<T>&);
+    SparsePolynomial<T>& operator *=(const SparsePolynomial<T>&);
+
+    T operator[](size_t exponent) const;
+    void Set(size_t exponent, const T& value);
+
+    T operator()(const T&) const;
+
+    int Degree() const;
+    size_t TermCount() const;
+    Representation PreferredRepresentation() const;
+
+    const std::vector<Term>& Terms() const;
+
+    void Shift(size_t shift);
+
+    void RawDivide(const SparsePolynomial<T>& rhs, SparsePolynomial<T>& quotient, SparsePolynomial<T>& mod) const;
+
+    friend SparsePolynomial operator +(SparsePolynomial lhs, const SparsePolynomial& rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend SparsePolynomial operator -(SparsePolynomial lhs, const SparsePolynomial& rhs)
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend SparsePolynomial operator *(const SparsePolynomial& lhs, const SparsePolynomial& rhs)
+    {
+        return SparsePolynomial(Product(lhs, rhs));
+    }
+
+    friend SparsePolynomial operator /(SparsePolynomial lhs, const SparsePolynomial& rhs)
+    {
+        std::vector<Term> quotient;
+        lhs.DivideInPlace(rhs, quotient);
+        return SparsePolynomial(std::move(quotient));
+    }
+
+    friend SparsePolynomial operator %(SparsePolynomial lhs, const SparsePolynomial& rhs)
+    {
+        std::vector<Term> quotient;
+        lhs.DivideInPlace(rhs, quotient);
+        return lhs;
+    }
+};
+
+
+template <class T>
+std::ostream& operator <<(std::ostream&, const SparsePolynomial<T>&);
+
+#include "SparsePolynomial.hpp"
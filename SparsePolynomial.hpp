@@ -0,0 +1,329 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+using std::vector;
+
+
+template<class T>
+T RaisePower(T base, size_t exponent) {
+    T result = T(1);
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result *= base;
+        }
+        exponent >>= 1;
+        if (exponent > 0) {
+            base *= base;
+        }
+    }
+    return result;
+}
+
+template<class T>
+SparsePolynomial<T>::SparsePolynomial(const T& coef) {
+    if (coef != T()) {
+        terms.push_back(Term(0, coef));
+    }
+}
+
+template<class T>
+SparsePolynomial<T>::SparsePolynomial(vector<Term> terms) : terms(std::move(terms)) {
+    Normalize();
+}
+
+template<class T>
+SparsePolynomial<T>::SparsePolynomial(const Polynomial<T>& dense) {
+    size_t index = 0;
+    for (typename Polynomial<T>::const_iterator iter = dense.begin(); index <= static_cast<size_t>(dense.Degree());
+         ++iter, ++index) {
+        if (*iter != T()) {
+            terms.push_back(Term(index, *iter));
+        }
+    }
+}
+
+template<class T>
+Polynomial<T> SparsePolynomial<T>::ToDense() const {
+    Polynomial<T> dense;
+    for (typename vector<Term>::const_reverse_iterator iter = terms.rbegin(); iter != terms.rend(); ++iter) {
+        dense[iter->first] = iter->second;
+    }
+    return dense;
+}
+
+template<class T>
+void SparsePolynomial<T>::Normalize() {
+    std::stable_sort(terms.begin(), terms.end(),
+                     [](const Term& lhs, const Term& rhs) { return lhs.first < rhs.first; });
+    size_t size = 0;
+    for (size_t index = 0; index < terms.size(); ++index) {
+        if (size > 0 && terms[size - 1].first == terms[index].first) {
+            terms[size - 1].second += terms[index].second;
+        } else {
+            terms[size++] = terms[index];
+        }
+        if (terms[size - 1].second == T()) {
+            --size;
+        }
+    }
+    terms.resize(size);
+}
+
+template<class T>
+bool SparsePolynomial<T>::operator ==(const SparsePolynomial<T>& other) const {
+    return terms == other.terms;
+}
+
+template<class T>
+bool SparsePolynomial<T>::operator !=(const SparsePolynomial<T>& other) const {
+    return !(*this == other);
+}
+
+template<class T>
+SparsePolynomial<T>& SparsePolynomial<T>::operator +=(const SparsePolynomial<T>& other) {
+    vector<Term> sum;
+    sum.reserve(terms.size() + other.terms.size());
+    size_t index = 0, other_index = 0;
+    while (index < terms.size() || other_index < other.terms.size()) {
+        if (other_index == other.terms.size()
+            || (index < terms.size() && terms[index].first < other.terms[other_index].first)) {
+            sum.push_back(terms[index++]);
+        } else if (index == terms.size() || other.terms[other_index].first < terms[index].first) {
+            sum.push_back(other.terms[other_index++]);
+        } else {
+            T coef = terms[index].second + other.terms[other_index].second;
+            if (coef != T()) {
+                sum.push_back(Term(terms[index].first, coef));
+            }
+            ++index;
+            ++other_index;
+        }
+    }
+    terms.swap(sum);
+
+    return *this;
+}
+
+template<class T>
+SparsePolynomial<T>& SparsePolynomial<T>::operator -=(const SparsePolynomial<T>& other) {
+    SparsePolynomial<T> negated(other);
+    for (size_t index = 0; index < negated.terms.size(); ++index) {
+        negated.terms[index].second = T() - negated.terms[index].second;
+    }
+    return *this += negated;
+}
+
+// Johnson's heap multiplication: one heap entry per term of the shorter
+// operand walks along the longer one, so the product terms come out in
+// increasing exponent order and equal exponents are merged on the fly.
+template<class T>
+vector<typename SparsePolynomial<T>::Term> SparsePolynomial<T>::Product(const SparsePolynomial<T>& lhs,
+                                                                      const SparsePolynomial<T>& rhs) {
+    if (lhs.terms.empty() || rhs.terms.empty()) {
+        return vector<Term>();
+    }
+
+    if (lhs.PreferredRepresentation() == Representation::Dense
+        && rhs.PreferredRepresentation() == Representation::Dense) {
+        vector<T> lhs_dense(lhs.Degree() + 1), rhs_dense(rhs.Degree() + 1);
+        for (size_t index = 0; index < lhs.terms.size(); ++index) {
+            lhs_dense[lhs.terms[index].first] = lhs.terms[index].second;
+        }
+        for (size_t index = 0; index < rhs.terms.size(); ++index) {
+            rhs_dense[rhs.terms[index].first] = rhs.terms[index].second;
+        }
+        vector<T> product(lhs_dense.size() + rhs_dense.size() - 1);
+        MultiplyCoefficients(&lhs_dense[0], lhs_dense.size(), &rhs_dense[0], rhs_dense.size(), &product[0]);
+
+        vector<Term> result;
+        for (size_t index = 0; index < product.size(); ++index) {
+            if (product[index] != T()) {
+                result.push_back(Term(index, product[index]));
+            }
+        }
+        return result;
+    }
+
+    const vector<Term>& rows = lhs.terms.size() <= rhs.terms.size() ? lhs.terms : rhs.terms;
+    const vector<Term>& columns = lhs.terms.size() <= rhs.terms.size() ? rhs.terms : lhs.terms;
+
+    typedef std::pair<size_t, std::pair<size_t, size_t> > Entry;
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry> > heap;
+    for (size_t row = 0; row < rows.size(); ++row) {
+        heap.push(Entry(rows[row].first + columns[0].first, std::make_pair(row, 0)));
+    }
+
+    vector<Term> result;
+    while (!heap.empty()) {
+        Entry entry = heap.top();
+        heap.pop();
+        size_t row = entry.second.first;
+        size_t column = entry.second.second;
+        T coef = rows[row].second * columns[column].second;
+
+        if (!result.empty() && result.back().first == entry.first) {
+            result.back().second += coef;
+        } else {
+            if (!result.empty() && result.back().second == T()) {
+                result.pop_back();
+            }
+            result.push_back(Term(entry.first, coef));
+        }
+
+        if (column + 1 < columns.size()) {
+            heap.push(Entry(rows[row].first + columns[column + 1].first, std::make_pair(row, column + 1)));
+        }
+    }
+    if (!result.empty() && result.back().second == T()) {
+        result.pop_back();
+    }
+    return result;
+}
+
+template<class T>
+SparsePolynomial<T>& SparsePolynomial<T>::operator *=(const SparsePolynomial<T>& other) {
+    vector<Term> product = Product(*this, other);
+    terms.swap(product);
+
+    return *this;
+}
+
+template<class T>
+T SparsePolynomial<T>::operator[](size_t exponent) const {
+    typename vector<Term>::const_iterator iter = std::lower_bound(
+        terms.begin(), terms.end(), exponent, [](const Term& term, size_t value) { return term.first < value; });
+    if (iter == terms.end() || iter->first != exponent) {
+        return T();
+    }
+    return iter->second;
+}
+
+template<class T>
+void SparsePolynomial<T>::Set(size_t exponent, const T& value) {
+    typename vector<Term>::iterator iter = std::lower_bound(
+        terms.begin(), terms.end(), exponent, [](const Term& term, size_t value) { return term.first < value; });
+    bool found = iter != terms.end() && iter->first == exponent;
+    if (value == T()) {
+        if (found) {
+            terms.erase(iter);
+        }
+    } else if (found) {
+        iter->second = value;
+    } else {
+        terms.insert(iter, Term(exponent, value));
+    }
+}
+
+// Horner's scheme over the gaps between consecutive exponents, each power of
+// arg is computed by repeated squaring.
+template<class T>
+T SparsePolynomial<T>::operator()(const T& arg) const {
+    if (terms.empty()) {
+        return T();
+    }
+    T value = terms.back().second;
+    for (size_t index = terms.size() - 1; index-- > 0;) {
+        value = value * RaisePower(arg, terms[index + 1].first - terms[index].first) + terms[index].second;
+    }
+    return value * RaisePower(arg, terms[0].first);
+}
+
+template<class T>
+int SparsePolynomial<T>::Degree() const {
+    return terms.empty() ? 0 : static_cast<int>(terms.back().first);
+}
+
+template<class T>
+size_t SparsePolynomial<T>::TermCount() const {
+    return terms.size();
+}
+
+template<class T>
+Representation SparsePolynomial<T>::PreferredRepresentation() const {
+    return ChooseRepresentation(terms.size(), Degree());
+}
+
+template<class T>
+const vector<typename SparsePolynomial<T>::Term>& SparsePolynomial<T>::Terms() const {
+    return terms;
+}
+
+template<class T>
+void SparsePolynomial<T>::Shift(size_t shift) {
+    for (size_t index = 0; index < terms.size(); ++index) {
+        terms[index].first += shift;
+    }
+}
+
+// Long division on the remainder kept in a map from the highest exponent
+// down; like the dense division, integer quotients stop at the first leading
+// term the divisor's leading coefficient does not divide.
+template<class T>
+void SparsePolynomial<T>::DivideInPlace(const SparsePolynomial<T>& rhs, vector<Term>& quotient) {
+    if (rhs.terms.empty()) {
+        throw std::overflow_error("Divide by zero");
+    }
+
+    quotient.clear();
+    const Term& lead = rhs.terms.back();
+    std::map<size_t, T, std::greater<size_t> > remainder;
+    for (size_t index = 0; index < terms.size(); ++index) {
+        remainder[terms[index].first] = terms[index].second;
+    }
+
+    while (!remainder.empty() && remainder.begin()->first >= lead.first) {
+        size_t exponent = remainder.begin()->first;
+        T coef = remainder.begin()->second / lead.second;
+        if (coef == T()) {
+            break;
+        }
+        if (!CoefficientTraits<T>::is_field && remainder.begin()->second - coef * lead.second != T()) {
+            break;
+        }
+
+        size_t shift = exponent - lead.first;
+        quotient.push_back(Term(shift, coef));
+        remainder.erase(remainder.begin());
+        for (size_t index = 0; index + 1 < rhs.terms.size(); ++index) {
+            T& target = remainder[rhs.terms[index].first + shift];
+            target -= coef * rhs.terms[index].second;
+            if (target == T()) {
+                remainder.erase(rhs.terms[index].first + shift);
+            }
+        }
+    }
+
+    std::reverse(quotient.begin(), quotient.end());
+    terms.assign(remainder.rbegin(), remainder.rend());
+}
+
+template<class T>
+void SparsePolynomial<T>::RawDivide(const SparsePolynomial<T>& rhs,
+                                    SparsePolynomial<T>& quotient, SparsePolynomial<T>& mod) const {
+    SparsePolynomial<T> remainder(*this);
+    vector<Term> quotient_terms;
+    remainder.DivideInPlace(rhs, quotient_terms);
+
+    quotient = SparsePolynomial<T>(std::move(quotient_terms));
+    mod = std::move(remainder);
+}
+
+template<class T>
+std::ostream& operator <<(std::ostream& stream, const SparsePolynomial<T>& polynomial) {
+    const vector<typename SparsePolynomial<T>::Term>& terms = polynomial.Terms();
+    if (terms.empty()) {
+        AddMonomial(T(), 0, stream, true);
+        return stream;
+    }
+    for (size_t index = terms.size(); index-- > 0;) {
+        AddMonomial(terms[index].second, static_cast<int>(terms[index].first), stream, index + 1 == terms.size());
+    }
+
+    return stream;
+}
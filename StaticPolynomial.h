@@ -0,0 +1,81 @@
+#pragma once
+#include <iostream>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "Polynomial.h"
+
+
+// Polynomial of degree at most N with its N + 1 coefficients in a std::array,
+// lowest power first. All arithmetic is constexpr: evaluation and products
+// expand into folds over index sequences and the element-wise operations are
+// loops of fixed length, so everything compiles to straight-line code. Unlike
+// Polynomial<T> the leading coefficient may be zero; the degree of the type
+// stays N.
+template<class T, size_t N>
+class StaticPolynomial {
+private:
+    std::array<T, N + 1> coefficients;
+
+    template<size_t... Index>
+    constexpr T Horner(const T& arg, std::index_sequence<Index...>) const;
+
+public:
+    typedef T value_type;
+
+    static constexpr size_t max_degree = N;
+
+    constexpr StaticPolynomial();
+
+    constexpr StaticPolynomial(const T& coef);
+
+    constexpr explicit StaticPolynomial(const std::array<T, N + 1>& coefficients);
+
+    explicit StaticPolynomial(const Polynomial<T>& polynomial);
+
+    Polynomial<T> ToPolynomial() const;
+
+    constexpr bool operator ==(const StaticPolynomial<T, N>&) const;
+    constexpr bool operator !=(const StaticPolynomial<T, N>&) const;
+
+    constexpr StaticPolynomial<T, N>& operator +=(const StaticPolynomial<T, N>&);
+    constexpr StaticPolynomial<T, N>& operator -=(const StaticPolynomial<T, N>&);
+    constexpr StaticPolynomial<T, N>& operator *=(const T&);
+
+    constexpr const T& operator[](size_t) const;
+    constexpr T& operator[](size_t);
+
+    constexpr T operator()(const T&) const;
+
+    constexpr int Degree() const;
+
+    friend constexpr StaticPolynomial operator +(StaticPolynomial lhs, const StaticPolynomial& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend constexpr StaticPolynomial operator -(StaticPolynomial lhs, const StaticPolynomial& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend constexpr StaticPolynomial operator *(StaticPolynomial lhs, const T& factor)
+    {
+        return lhs *= factor;
+    }
+
+    friend constexpr StaticPolynomial operator *(const T& factor, StaticPolynomial rhs)
+    {
+        return rhs *= factor;
+    }
+};
+
+
+template<class T, size_t N, size_t M>
+constexpr StaticPolynomial<T, N + M> operator *(const StaticPolynomial<T, N>&, const StaticPolynomial<T, M>&);
+
+template<class T, size_t N>
+std::ostream& operator <<(std::ostream&, const StaticPolynomial<T, N>&);
+
+#include "StaticPolynomial.hpp"
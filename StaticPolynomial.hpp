@@ -0,0 +1,126 @@
+#pragma once
+#include <iostream>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>::StaticPolynomial() : coefficients() {}
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>::StaticPolynomial(const T& coef) : coefficients() {
+    coefficients[0] = coef;
+}
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>::StaticPolynomial(const std::array<T, N + 1>& coefficients)
+    : coefficients(coefficients) {}
+
+template<class T, size_t N>
+StaticPolynomial<T, N>::StaticPolynomial(const Polynomial<T>& polynomial) : coefficients() {
+    if (static_cast<size_t>(polynomial.Degree()) > N) {
+        throw std::out_of_range("Degree exceeds the static degree");
+    }
+    for (int index = 0; index <= polynomial.Degree(); ++index) {
+        coefficients[index] = polynomial[index];
+    }
+}
+
+template<class T, size_t N>
+Polynomial<T> StaticPolynomial<T, N>::ToPolynomial() const {
+    return Polynomial<T>(coefficients.rbegin(), coefficients.rend());
+}
+
+template<class T, size_t N>
+constexpr bool StaticPolynomial<T, N>::operator ==(const StaticPolynomial<T, N>& other) const {
+    for (size_t index = 0; index <= N; ++index) {
+        if (coefficients[index] != other.coefficients[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class T, size_t N>
+constexpr bool StaticPolynomial<T, N>::operator !=(const StaticPolynomial<T, N>& other) const {
+    return !(*this == other);
+}
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>& StaticPolynomial<T, N>::operator +=(const StaticPolynomial<T, N>& other) {
+    for (size_t index = 0; index <= N; ++index) {
+        coefficients[index] += other.coefficients[index];
+    }
+    return *this;
+}
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>& StaticPolynomial<T, N>::operator -=(const StaticPolynomial<T, N>& other) {
+    for (size_t index = 0; index <= N; ++index) {
+        coefficients[index] -= other.coefficients[index];
+    }
+    return *this;
+}
+
+template<class T, size_t N>
+constexpr StaticPolynomial<T, N>& StaticPolynomial<T, N>::operator *=(const T& factor) {
+    for (size_t index = 0; index <= N; ++index) {
+        coefficients[index] *= factor;
+    }
+    return *this;
+}
+
+template<class T, size_t N>
+constexpr const T& StaticPolynomial<T, N>::operator[](size_t index) const {
+    return coefficients[index];
+}
+
+template<class T, size_t N>
+constexpr T& StaticPolynomial<T, N>::operator[](size_t index) {
+    return coefficients[index];
+}
+
+// The fold expands into N multiply-adds with constant indices, so there is no
+// loop left to unroll.
+template<class T, size_t N>
+template<size_t... Index>
+constexpr T StaticPolynomial<T, N>::Horner(const T& arg, std::index_sequence<Index...>) const {
+    T value = coefficients[N];
+    ((value = value * arg + coefficients[N - 1 - Index]), ...);
+    return value;
+}
+
+template<class T, size_t N>
+constexpr T StaticPolynomial<T, N>::operator()(const T& arg) const {
+    return Horner(arg, std::make_index_sequence<N>());
+}
+
+template<class T, size_t N>
+constexpr int StaticPolynomial<T, N>::Degree() const {
+    int degree = static_cast<int>(N);
+    while (degree > 0 && coefficients[degree] == T()) {
+        --degree;
+    }
+    return degree;
+}
+
+// One multiply-add per pair of coefficients, the pair being decoded from a
+// single index so the whole product is one fold.
+template<class T, size_t N, size_t M, size_t... Index>
+constexpr StaticPolynomial<T, N + M> StaticProduct(const StaticPolynomial<T, N>& lhs, const StaticPolynomial<T, M>& rhs,
+                                                   std::index_sequence<Index...>) {
+    StaticPolynomial<T, N + M> product;
+    ((product[Index / (M + 1) + Index % (M + 1)] += lhs[Index / (M + 1)] * rhs[Index % (M + 1)]), ...);
+    return product;
+}
+
+template<class T, size_t N, size_t M>
+constexpr StaticPolynomial<T, N + M> operator *(const StaticPolynomial<T, N>& lhs, const StaticPolynomial<T, M>& rhs) {
+    return StaticProduct(lhs, rhs, std::make_index_sequence<(N + 1) * (M + 1)>());
+}
+
+template<class T, size_t N>
+std::ostream& operator <<(std::ostream& stream, const StaticPolynomial<T, N>& polynomial) {
+    return stream << polynomial.ToPolynomial();
+}
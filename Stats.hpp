@@ -0,0 +1,207 @@
+#pragma once
+#include <iostream>
+#include <cstddef>
+
+#ifdef POLYNOMIAL_STATS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#endif
+
+
+// Counters of what the polynomial code does, compiled in only when
+// POLYNOMIAL_STATS is defined. Each thread counts into its own block without
+// synchronization; PolynomialStats::Collect() adds up the blocks of all live
+// threads and of the threads that have exited. Without the macro CountStat is
+// empty and Collect() returns zeros.
+enum class StatCounter {
+    Additions,
+    Subtractions,
+    Multiplications,
+    Scalings,
+    Divisions,
+    Evaluations,
+    CachedEvaluations,
+    Gcds,
+    Expressions,
+    CoefficientMultiplies,
+    Normalizations,
+    TrimmedCoefficients,
+    Allocations,
+    AllocatedBytes,
+    CopiedBytes,
+    Schoolbook,
+    Karatsuba,
+    Toom3,
+    Fft,
+    Ntt,
+    ModularNtt,
+    MultiModular,
+    LongDivision,
+    NewtonDivision,
+    EuclidSteps,
+    HalfGcd,
+    ModularGcd,
+    Count
+};
+
+inline const char* StatName(StatCounter counter) {
+    static const char* const names[] = {
+        "additions", "subtractions", "multiplications", "scalings", "divisions", "evaluations", "cached_evaluations",
+        "gcds", "expressions", "coefficient_multiplies", "normalizations", "trimmed_coefficients", "allocations",
+        "allocated_bytes", "copied_bytes", "schoolbook", "karatsuba", "toom3", "fft", "ntt", "modular_ntt",
+        "multi_modular", "long_division", "newton_division", "euclid_steps", "half_gcd", "modular_gcd"
+    };
+    return names[static_cast<size_t>(counter)];
+}
+
+class PolynomialStats {
+private:
+    static const size_t kCounters = static_cast<size_t>(StatCounter::Count);
+
+    unsigned long long counters[kCounters];
+
+    friend class StatsRegistry;
+
+public:
+#ifdef POLYNOMIAL_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    PolynomialStats() : counters() {}
+
+    unsigned long long operator[](StatCounter counter) const {
+        return counters[static_cast<size_t>(counter)];
+    }
+
+    PolynomialStats& operator -=(const PolynomialStats& other) {
+        for (size_t index = 0; index < kCounters; ++index) {
+            counters[index] -= other.counters[index];
+        }
+        return *this;
+    }
+
+    friend PolynomialStats operator -(PolynomialStats lhs, const PolynomialStats& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    // Sum over all threads since the last Reset().
+    static PolynomialStats Collect();
+
+    // Starts counting from zero again; counters of other threads are not
+    // touched, the current totals are remembered and subtracted instead.
+    static void Reset();
+
+    friend std::ostream& operator <<(std::ostream& stream, const PolynomialStats& stats)
+    {
+        for (size_t index = 0; index < kCounters; ++index) {
+            if (index > 0) {
+                stream << ' ';
+            }
+            stream << StatName(static_cast<StatCounter>(index)) << '=' << stats.counters[index];
+        }
+        return stream;
+    }
+};
+
+#ifdef POLYNOMIAL_STATS
+
+// Holds the counter blocks of the live threads and the sums left by the
+// exited ones.
+class StatsRegistry {
+public:
+    // Only the owning thread writes its block; the relaxed load and store keep
+    // the increment a plain add while letting Collect() read it concurrently.
+    struct ThreadBlock {
+        std::atomic<unsigned long long> counters[PolynomialStats::kCounters];
+
+        ThreadBlock();
+        ~ThreadBlock();
+    };
+
+private:
+    std::mutex mutex;
+    std::vector<ThreadBlock*> blocks;
+    PolynomialStats exited;
+    PolynomialStats baseline;
+
+    PolynomialStats Total() const {
+        PolynomialStats total = exited;
+        for (const ThreadBlock* block : blocks) {
+            for (size_t index = 0; index < PolynomialStats::kCounters; ++index) {
+                total.counters[index] += block->counters[index].load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+public:
+    static StatsRegistry& Instance() {
+        static StatsRegistry registry;
+        return registry;
+    }
+
+    void Add(ThreadBlock* block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.push_back(block);
+    }
+
+    void Remove(ThreadBlock* block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t index = 0; index < PolynomialStats::kCounters; ++index) {
+            exited.counters[index] += block->counters[index].load(std::memory_order_relaxed);
+        }
+        blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+    }
+
+    PolynomialStats Collect() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Total() - baseline;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        baseline = Total();
+    }
+};
+
+inline StatsRegistry::ThreadBlock::ThreadBlock() {
+    for (size_t index = 0; index < PolynomialStats::kCounters; ++index) {
+        counters[index].store(0, std::memory_order_relaxed);
+    }
+    StatsRegistry::Instance().Add(this);
+}
+
+inline StatsRegistry::ThreadBlock::~ThreadBlock() {
+    StatsRegistry::Instance().Remove(this);
+}
+
+inline PolynomialStats PolynomialStats::Collect() {
+    return StatsRegistry::Instance().Collect();
+}
+
+inline void PolynomialStats::Reset() {
+    StatsRegistry::Instance().Reset();
+}
+
+inline void CountStat(StatCounter counter, unsigned long long amount = 1) {
+    static thread_local StatsRegistry::ThreadBlock block;
+    std::atomic<unsigned long long>& value = block.counters[static_cast<size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+#else
+
+inline PolynomialStats PolynomialStats::Collect() {
+    return PolynomialStats();
+}
+
+inline void PolynomialStats::Reset() {}
+
+inline void CountStat(StatCounter, unsigned long long = 1) {}
+
+#endif
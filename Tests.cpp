@@ -1,6 +1,23 @@
 #include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <fstream>
 
 #include "Polynomial.h"
+#include "SparsePolynomial.h"
+#include "ModInt.h"
+#include "StaticPolynomial.h"
+#include "Serialization.h"
+#include "TextFormat.h"
+#include "PolynomialBatch.h"
+#include "Roots.h"
+#include "BigInt.h"
+#include "CachedPolynomial.h"
+#include "AllocationCounter.hpp"
 
 #define BOOST_TEST_MODULE MyTest
 #include <boost\test\unit_test.hpp>
@@ -15,6 +32,124 @@ Polynomial<int> generate_polynom(int degree) {
 }
 
 
+template<class Function>
+size_t count_allocations(Function function) {
+    size_t before = allocations;
+    function();
+    return allocations - before;
+}
+
+template<class T>
+Polynomial<T> generate_random_polynom(int degree, unsigned seed, int bound = 1000) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-bound, bound);
+    vector<T> seq;
+    for (int i = 0; i < degree + 1; ++i) {
+        seq.push_back(T(distribution(generator)));
+    }
+    seq[0] = T(bound);
+    Polynomial<T> polynom(seq.begin(), seq.end());
+    return polynom;
+}
+
+template<class T>
+SparsePolynomial<T> generate_sparse_polynom(int terms, int degree, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> exponents(0, degree - 1);
+    std::uniform_int_distribution<int> coefficients(-50, 50);
+    vector<typename SparsePolynomial<T>::Term> seq;
+    for (int i = 0; i < terms; ++i) {
+        seq.push_back(typename SparsePolynomial<T>::Term(exponents(generator), T(coefficients(generator))));
+    }
+    seq.push_back(typename SparsePolynomial<T>::Term(degree, T(1)));
+    return SparsePolynomial<T>(seq);
+}
+
+template<class T>
+Polynomial<T> naive_product(const Polynomial<T>& lhs, const Polynomial<T>& rhs) {
+    Polynomial<T> product;
+    product[lhs.Degree() + rhs.Degree()] = T();
+    // Signed integers wrap modulo 2^W, as the library's products do.
+    typedef typename WrappingKernel<T>::type W;
+    vector<W> coefficients(lhs.Degree() + rhs.Degree() + 1);
+    for (int i = 0; i <= lhs.Degree(); ++i) {
+        for (int j = 0; j <= rhs.Degree(); ++j) {
+            coefficients[i + j] += static_cast<W>(lhs[i]) * static_cast<W>(rhs[j]);
+        }
+    }
+    for (size_t i = 0; i < coefficients.size(); ++i) {
+        product[i] = static_cast<T>(coefficients[i]);
+    }
+    return product;
+}
+
+struct Residue {
+    int value;
+
+    Residue(int number = 0) : value((number % 10007 + 10007) % 10007) {}
+
+    Residue& operator +=(const Residue& other) { value = (value + other.value) % 10007; return *this; }
+    Residue& operator -=(const Residue& other) { value = (value + 10007 - other.value) % 10007; return *this; }
+    Residue& operator *=(const Residue& other) { value = value * other.value % 10007; return *this; }
+    Residue& operator /=(const Residue& other) {
+        int inverse = 1;
+        for (int power = 10005, base = other.value; power > 0; power >>= 1, base = base * base % 10007) {
+            if (power & 1) {
+                inverse = inverse * base % 10007;
+            }
+        }
+        return *this *= Residue(inverse);
+    }
+
+    Residue operator -() const { return Residue(-value); }
+    friend Residue operator +(Residue lhs, const Residue& rhs) { return lhs += rhs; }
+    friend Residue operator -(Residue lhs, const Residue& rhs) { return lhs -= rhs; }
+    friend Residue operator *(Residue lhs, const Residue& rhs) { return lhs *= rhs; }
+    friend Residue operator /(Residue lhs, const Residue& rhs) { return lhs /= rhs; }
+    friend bool operator ==(const Residue& lhs, const Residue& rhs) { return lhs.value == rhs.value; }
+    friend bool operator !=(const Residue& lhs, const Residue& rhs) { return lhs.value != rhs.value; }
+    friend bool operator <(const Residue& lhs, const Residue& rhs) { return lhs.value < rhs.value; }
+};
+
+template<>
+struct CoefficientTraits<Residue> {
+    static const bool is_field = true;
+    static const bool is_exact = true;
+};
+
+template<class T>
+Polynomial<T> monic(Polynomial<T> polynom) {
+    T lead = polynom[polynom.Degree()];
+    for (int i = 0; i <= polynom.Degree(); ++i) {
+        polynom[i] /= lead;
+    }
+    return polynom;
+}
+
+struct ThresholdsGuard {
+    size_t karatsuba;
+    size_t toom3;
+    size_t fft;
+    size_t ntt;
+
+    ThresholdsGuard(size_t new_karatsuba, size_t new_toom3, size_t new_fft = 1u << 30, size_t new_ntt = 1u << 30)
+        : karatsuba(MultiplicationThresholds::karatsuba), toom3(MultiplicationThresholds::toom3),
+          fft(MultiplicationThresholds::fft), ntt(MultiplicationThresholds::ntt) {
+        MultiplicationThresholds::karatsuba = new_karatsuba;
+        MultiplicationThresholds::toom3 = new_toom3;
+        MultiplicationThresholds::fft = new_fft;
+        MultiplicationThresholds::ntt = new_ntt;
+    }
+
+    ~ThresholdsGuard() {
+        MultiplicationThresholds::karatsuba = karatsuba;
+        MultiplicationThresholds::toom3 = toom3;
+        MultiplicationThresholds::fft = fft;
+        MultiplicationThresholds::ntt = ntt;
+    }
+};
+
+
 BOOST_AUTO_TEST_CASE(test_data) {
     Polynomial<int> polynomial = generate_polynom(5);
     BOOST_CHECK_EQUAL(polynomial[2], 4);
@@ -342,3 +477,1286 @@ BOOST_AUTO_TEST_CASE(test_strange) {
     polynom_first += polynom_second;
     BOOST_CHECK_EQUAL(polynom_first[0], "One Three ");
 }
+
+// Bounds keep min(n, m) * bound^2 inside the type, so the products are exact
+// rather than agreeing modulo 2^W only.
+BOOST_AUTO_TEST_CASE(test_karatsuba_mult) {
+    ThresholdsGuard guard(4, 1000000);
+    int sizes[][2] = {{37, 37}, {64, 64}, {50, 13}, {5, 120}, {100, 0}};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        Polynomial<int> lhs = generate_random_polynom<int>(sizes[i][0], 2 * i, 1000);
+        Polynomial<int> rhs = generate_random_polynom<int>(sizes[i][1], 2 * i + 1, 1000);
+        BOOST_CHECK_EQUAL(lhs * rhs, naive_product(lhs, rhs));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_toom3_mult) {
+    ThresholdsGuard guard(4, 9);
+    int sizes[][2] = {{37, 37}, {80, 80}, {300, 41}, {9, 200}, {1000, 1000}};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        Polynomial<int> lhs = generate_random_polynom<int>(sizes[i][0], 2 * i, 1000);
+        Polynomial<int> rhs = generate_random_polynom<int>(sizes[i][1], 2 * i + 1, 1000);
+        BOOST_CHECK_EQUAL(lhs * rhs, naive_product(lhs, rhs));
+
+        Polynomial<long long> wide_lhs = generate_random_polynom<long long>(sizes[i][0], 2 * i, 10000000);
+        Polynomial<long long> wide_rhs = generate_random_polynom<long long>(sizes[i][1], 2 * i + 1, 10000000);
+        BOOST_CHECK_EQUAL(wide_lhs * wide_rhs, naive_product(wide_lhs, wide_rhs));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_toom3_double_mult) {
+    ThresholdsGuard guard(4, 9);
+    Polynomial<double> lhs = generate_random_polynom<double>(150, 7);
+    Polynomial<double> rhs = generate_random_polynom<double>(120, 8);
+    Polynomial<double> product = lhs * rhs;
+    Polynomial<double> required = naive_product(lhs, rhs);
+    BOOST_REQUIRE_EQUAL(product.Degree(), required.Degree());
+    for (int i = 0; i <= required.Degree(); ++i) {
+        BOOST_CHECK_SMALL(product[i] - required[i], 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stress_fast_mult_test) {
+    Polynomial<int> polynom = generate_polynom(20000);
+    Polynomial<int> multiplier = generate_polynom(20000);
+    Polynomial<int> product = polynom * multiplier;
+    BOOST_CHECK_EQUAL(product.Degree(), 40000);
+    BOOST_CHECK_EQUAL(product[40000], 1);
+    BOOST_CHECK_EQUAL(product[39999], 4);
+    BOOST_CHECK_EQUAL(product[0], 400040001);
+}
+
+BOOST_AUTO_TEST_CASE(test_ntt_mult) {
+    ThresholdsGuard guard(32, 200, 1, 1);
+    int sizes[][2] = {{1, 1}, {37, 37}, {300, 41}, {1000, 1000}};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        Polynomial<int> lhs = generate_random_polynom<int>(sizes[i][0], 2 * i, 30000);
+        Polynomial<int> rhs = generate_random_polynom<int>(sizes[i][1], 2 * i + 1, 30000);
+        BOOST_CHECK_EQUAL(lhs * rhs, naive_product(lhs, rhs));
+
+        Polynomial<long long> wide_lhs = generate_random_polynom<long long>(sizes[i][0], 2 * i, 1000000000);
+        Polynomial<long long> wide_rhs = generate_random_polynom<long long>(sizes[i][1], 2 * i + 1, 1000000000);
+        wide_lhs[0] = 4000000000000000000LL;
+        BOOST_CHECK_EQUAL(wide_lhs * wide_rhs, naive_product(wide_lhs, wide_rhs));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fft_mult) {
+    ThresholdsGuard guard(32, 200, 1, 1);
+    Polynomial<double> lhs = generate_random_polynom<double>(3000, 11);
+    Polynomial<double> rhs = generate_random_polynom<double>(2500, 12);
+    Polynomial<double> product = lhs * rhs;
+    Polynomial<double> required = naive_product(lhs, rhs);
+    double bound = FftErrorBound(1000, 1000, 2501, TransformSize(5501));
+    BOOST_REQUIRE_EQUAL(product.Degree(), required.Degree());
+    for (int i = 0; i <= required.Degree(); ++i) {
+        BOOST_CHECK_SMALL(product[i] - required[i], bound);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stress_ntt_mult_test) {
+    Polynomial<int> polynom = generate_polynom(100000);
+    Polynomial<int> multiplier = generate_polynom(100000);
+    Polynomial<int> product = polynom * multiplier;
+    BOOST_CHECK_EQUAL(product.Degree(), 200000);
+    BOOST_CHECK_EQUAL(product[200000], 1);
+    BOOST_CHECK_EQUAL(product[199999], 4);
+    BOOST_CHECK_EQUAL(product[199998], 10);
+    BOOST_CHECK_EQUAL(product[199997], 20);
+}
+
+BOOST_AUTO_TEST_CASE(test_newton_divide) {
+    size_t newton = DivisionThresholds::newton;
+    Polynomial<int> divisor = generate_random_polynom<int>(300, 21, 5);
+    divisor[300] = 1;
+    Polynomial<int> quotient = generate_random_polynom<int>(500, 22, 5);
+    Polynomial<int> remainder = generate_random_polynom<int>(299, 23, 5);
+    Polynomial<int> dividend = divisor * quotient + remainder;
+
+    DivisionThresholds::newton = 1u << 30;
+    Polynomial<int> long_quotient = dividend / divisor;
+    Polynomial<int> long_remainder = dividend % divisor;
+    DivisionThresholds::newton = 16;
+    Polynomial<int> newton_quotient = dividend / divisor;
+    Polynomial<int> newton_remainder = dividend % divisor;
+    DivisionThresholds::newton = newton;
+
+    BOOST_CHECK_EQUAL(long_quotient, quotient);
+    BOOST_CHECK_EQUAL(long_remainder, remainder);
+    BOOST_CHECK_EQUAL(newton_quotient, quotient);
+    BOOST_CHECK_EQUAL(newton_remainder, remainder);
+}
+
+BOOST_AUTO_TEST_CASE(test_newton_double_divide) {
+    size_t newton = DivisionThresholds::newton;
+    DivisionThresholds::newton = 16;
+    Polynomial<double> divisor = generate_random_polynom<double>(100, 31, 1);
+    divisor[100] = 64;
+    Polynomial<double> quotient = generate_random_polynom<double>(120, 32, 5);
+    Polynomial<double> remainder = generate_random_polynom<double>(99, 33, 5);
+    Polynomial<double> dividend = divisor * quotient + remainder;
+    Polynomial<double> result_quotient = dividend / divisor;
+    Polynomial<double> result_remainder = dividend % divisor;
+    DivisionThresholds::newton = newton;
+
+    BOOST_REQUIRE_EQUAL(result_quotient.Degree(), quotient.Degree());
+    for (int i = 0; i <= quotient.Degree(); ++i) {
+        BOOST_CHECK_SMALL(result_quotient[i] - quotient[i], 1e-6);
+    }
+    for (int i = 0; i <= remainder.Degree(); ++i) {
+        BOOST_CHECK_SMALL((i <= result_remainder.Degree() ? result_remainder[i] : 0.0) - remainder[i], 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_truncated_int_divide) {
+    Polynomial<int> dividend = Polynomial<int>(1);
+    dividend[1] = 4;
+    dividend[2] = 7;
+    Polynomial<int> diviser = Polynomial<int>(1);
+    diviser[1] = 2;
+    Polynomial<int> quotient = Polynomial<int>(0);
+    quotient[1] = 3;
+    Polynomial<int> remainder = Polynomial<int>(1);
+    remainder[1] = 1;
+    remainder[2] = 1;
+    BOOST_CHECK_EQUAL(dividend / diviser, quotient);
+    BOOST_CHECK_EQUAL(dividend % diviser, remainder);
+}
+
+BOOST_AUTO_TEST_CASE(stress_newton_divide_test) {
+    Polynomial<int> dividend = generate_polynom(40000);
+    Polynomial<int> diviser = generate_polynom(20000);
+    Polynomial<int> quotient = dividend / diviser;
+    BOOST_CHECK_EQUAL(quotient.Degree(), 20000);
+    BOOST_CHECK_EQUAL(quotient[20000], 1);
+    BOOST_CHECK_EQUAL(quotient[19999], 0);
+    BOOST_CHECK_EQUAL(quotient[0], 0);
+    BOOST_CHECK_EQUAL((dividend % diviser).Degree(), 19999);
+}
+
+BOOST_AUTO_TEST_CASE(test_half_gcd) {
+    Polynomial<Residue> common = generate_random_polynom<Residue>(60, 41);
+    Polynomial<Residue> first = common * generate_random_polynom<Residue>(250, 42);
+    Polynomial<Residue> second = common * generate_random_polynom<Residue>(190, 43);
+
+    size_t half_gcd = GcdThresholds::half_gcd;
+    GcdThresholds::half_gcd = 1u << 30;
+    Polynomial<Residue> euclid = (first, second);
+    GcdThresholds::half_gcd = 8;
+    Polynomial<Residue> fast = (first, second);
+    GcdThresholds::half_gcd = half_gcd;
+
+    BOOST_CHECK_EQUAL(fast.Degree(), 60);
+    BOOST_CHECK(fast == euclid);
+    BOOST_CHECK(monic(fast) == monic(common));
+}
+
+BOOST_AUTO_TEST_CASE(test_gcd_ex) {
+    Polynomial<Residue> common = generate_random_polynom<Residue>(20, 51);
+    Polynomial<Residue> first = common * generate_random_polynom<Residue>(150, 52);
+    Polynomial<Residue> second = common * generate_random_polynom<Residue>(170, 53);
+
+    size_t half_gcd = GcdThresholds::half_gcd;
+    GcdThresholds::half_gcd = 8;
+    Polynomial<Residue> first_factor, second_factor;
+    Polynomial<Residue> gcd = GcdEx(first, second, first_factor, second_factor);
+    GcdThresholds::half_gcd = half_gcd;
+
+    BOOST_CHECK(monic(gcd) == monic(common));
+    BOOST_CHECK(first_factor * first + second_factor * second == gcd);
+    BOOST_CHECK_LT(first_factor.Degree(), second.Degree());
+    BOOST_CHECK_LT(second_factor.Degree(), first.Degree());
+}
+
+BOOST_AUTO_TEST_CASE(test_int_gcd_ex) {
+    Polynomial<int> first = Polynomial<int>(-1);
+    first[2] = 1;
+    Polynomial<int> second = Polynomial<int>(1);
+    second[1] = 1;
+    Polynomial<int> first_factor, second_factor;
+    Polynomial<int> gcd = GcdEx(first, second, first_factor, second_factor);
+    BOOST_CHECK_EQUAL(gcd, second);
+    BOOST_CHECK_EQUAL(first_factor * first + second_factor * second, gcd);
+
+    // No integer cofactors give gcd(x, 2) = 1, so the result keeps the 2.
+    Polynomial<long long> monomial(0), two(2);
+    monomial[1] = 1;
+    Polynomial<long long> monomial_factor, two_factor;
+    BOOST_CHECK_EQUAL(GcdEx(monomial, two, monomial_factor, two_factor), two);
+    BOOST_CHECK_EQUAL(monomial_factor * monomial + two_factor * two, two);
+
+    Polynomial<BigInt> common = generate_random_polynom<BigInt>(3, 54, 20);
+    Polynomial<BigInt> lhs = common * generate_random_polynom<BigInt>(6, 55, 20);
+    Polynomial<BigInt> rhs = common * generate_random_polynom<BigInt>(5, 56, 20);
+    Polynomial<BigInt> lhs_factor, rhs_factor;
+    Polynomial<BigInt> big_gcd = GcdEx(lhs, rhs, lhs_factor, rhs_factor);
+    BOOST_CHECK_EQUAL(lhs_factor * lhs + rhs_factor * rhs, big_gcd);
+    BOOST_CHECK_EQUAL(big_gcd.Degree(), 3);
+    BOOST_CHECK(big_gcd[3] > BigInt(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_move_semantics) {
+    Polynomial<int> polynom = generate_polynom(5);
+    Polynomial<int> copy(polynom);
+    Polynomial<int> moved(std::move(copy));
+    BOOST_CHECK_EQUAL(moved, polynom);
+    Polynomial<int> assigned;
+    assigned = std::move(moved);
+    BOOST_CHECK_EQUAL(assigned, polynom);
+    BOOST_CHECK_EQUAL(count_allocations([&] { moved = std::move(assigned); }), 0u);
+    BOOST_CHECK_EQUAL(moved, polynom);
+
+    // Moved-from polynomials, inline and spilled to the heap, are zero and usable.
+    Polynomial<int> zero;
+    Polynomial<int> large = generate_polynom(40);
+    for (Polynomial<int>* source : {&assigned, &large}) {
+        Polynomial<int> target(std::move(*source));
+        BOOST_CHECK_EQUAL(source->Degree(), 0);
+        BOOST_CHECK_EQUAL(*source, zero);
+        BOOST_CHECK(source->end() - source->begin() == zero.end() - zero.begin());
+        *source += target;
+        BOOST_CHECK_EQUAL(*source, target);
+        target = std::move(*source);
+        BOOST_CHECK_EQUAL(*source, zero);
+        *source *= target;
+        BOOST_CHECK_EQUAL(*source, zero);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_expression_allocations) {
+    Polynomial<int> a = generate_polynom(20);
+    Polynomial<int> b = generate_polynom(20);
+    Polynomial<int> c = generate_polynom(20);
+    Polynomial<int> d = generate_polynom(20);
+    Polynomial<int> e = generate_polynom(19);
+    Polynomial<int> result;
+
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = a * b + c * d - e; }), 2u);
+    BOOST_CHECK_EQUAL(result, naive_product(a, b) + naive_product(c, d) - e);
+
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = a + b - c + d; }), 1u);
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = e - a * b; }), 1u);
+    BOOST_CHECK_EQUAL(result, e - naive_product(a, b));
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = (a - e) * b; }), 2u);
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = a * b % c; }), 2u);
+    BOOST_CHECK_EQUAL(result, naive_product(a, b) % c);
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = a * b / c; }), 2u);
+    BOOST_CHECK_EQUAL(result, naive_product(a, b) / c);
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_expressions) {
+    Polynomial<int> a = generate_random_polynom<int>(40, 31);
+    Polynomial<int> b = generate_random_polynom<int>(25, 32);
+    Polynomial<int> c = generate_random_polynom<int>(40, 33);
+    Polynomial<int> d = generate_random_polynom<int>(10, 34);
+
+    Polynomial<int> expected(a);
+    expected += b;
+    expected -= c;
+    expected *= Polynomial<int>(3);
+    expected += d;
+
+    Polynomial<int> result;
+    BOOST_CHECK_EQUAL(count_allocations([&] { result = (a + b - c) * 3 + d; }), 1u);
+    BOOST_CHECK_EQUAL(result, expected);
+    BOOST_CHECK_EQUAL(result.Degree(), 39);
+
+    int value = 0;
+    BOOST_CHECK_EQUAL(count_allocations([&] { value = ((a + b - c) * 3 + d)(2); }), 0u);
+    BOOST_CHECK_EQUAL(value, expected(2));
+
+    BOOST_CHECK_EQUAL(2 * a - a * 2, Polynomial<int>());
+    BOOST_CHECK_EQUAL(a + 1 - a, Polynomial<int>(1));
+
+    // Nodes kept past the full expression own the scalars they were given.
+    vector<double> seq = {1, -2, 0.5};
+    Polynomial<double> real(seq.begin(), seq.end());
+    auto plus = real + 2.0;
+    auto minus = 3.0 - real;
+    Polynomial<double> plus_result = plus;
+    Polynomial<double> minus_result = minus;
+    BOOST_CHECK_EQUAL(plus_result, ParsePolynomial<double>("x^2 - 2x + 2.5"));
+    BOOST_CHECK_EQUAL(minus_result, ParsePolynomial<double>("-x^2 + 2x + 2.5"));
+    BOOST_CHECK_EQUAL(plus(2.0), real(2.0) + 2.0);
+
+    Polynomial<int> accumulated(a);
+    accumulated += b - c;
+    BOOST_CHECK_EQUAL(accumulated, a + b - c);
+    accumulated -= accumulated - d;
+    BOOST_CHECK_EQUAL(accumulated, d);
+}
+
+BOOST_AUTO_TEST_CASE(test_multipoint_evaluate) {
+    Polynomial<int> polynom = generate_polynom(4);
+    vector<int> points;
+    for (int point = -6; point <= 6; ++point) {
+        points.push_back(point);
+    }
+    vector<int> values = polynom.Evaluate(points);
+    BOOST_REQUIRE_EQUAL(values.size(), points.size());
+    for (size_t index = 0; index < points.size(); ++index) {
+        BOOST_CHECK_EQUAL(values[index], polynom(points[index]));
+    }
+    BOOST_CHECK(polynom.Evaluate(vector<int>()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_subproduct_tree_evaluate) {
+    Polynomial<Residue> polynom = generate_random_polynom<Residue>(300, 61);
+    vector<Residue> points;
+    for (int point = 0; point < 700; ++point) {
+        points.push_back(Residue(point * 37 - 5000));
+    }
+
+    size_t subproduct_tree = EvaluationThresholds::subproduct_tree;
+    size_t tree_leaf = EvaluationThresholds::tree_leaf;
+    EvaluationThresholds::subproduct_tree = 64;
+    EvaluationThresholds::tree_leaf = 8;
+    vector<Residue> values = polynom.Evaluate(points);
+    EvaluationThresholds::subproduct_tree = subproduct_tree;
+    EvaluationThresholds::tree_leaf = tree_leaf;
+
+    for (size_t index = 0; index < points.size(); ++index) {
+        BOOST_CHECK(values[index] == polynom(points[index]));
+    }
+}
+
+template<class T>
+void check_simd_kernels(SimdLevel level) {
+    Polynomial<T> lhs = generate_random_polynom<T>(1000, 71, 100);
+    Polynomial<T> rhs = generate_random_polynom<T>(603, 72, 100);
+    vector<T> points;
+    for (int point = -40; point <= 40; ++point) {
+        points.push_back(T(point % 9) / T(4));
+    }
+    Polynomial<T> small = generate_random_polynom<T>(5, 73, 10);
+
+    SimdLevel detected = SimdSettings::level;
+    SimdSettings::level = SimdLevel::Scalar;
+    Polynomial<T> sum = lhs, diff = rhs, scaled = lhs, axpy = rhs;
+    sum += rhs;
+    diff -= lhs;
+    scaled *= T(3);
+    axpy += T(5) * lhs;
+    vector<T> values = small.Evaluate(points);
+
+    SimdSettings::level = level;
+    Polynomial<T> simd_sum = lhs, simd_diff = rhs, simd_scaled = lhs, simd_axpy = rhs;
+    simd_sum += rhs;
+    simd_diff -= lhs;
+    simd_scaled *= T(3);
+    simd_axpy += T(5) * lhs;
+    vector<T> simd_values = small.Evaluate(points);
+    SimdSettings::level = detected;
+
+    BOOST_CHECK(simd_sum == sum);
+    BOOST_CHECK(simd_diff == diff);
+    BOOST_CHECK(simd_scaled == scaled);
+    BOOST_CHECK(simd_axpy == axpy);
+    BOOST_CHECK(simd_axpy == rhs + lhs * T(5));
+    BOOST_CHECK(simd_values == values);
+}
+
+BOOST_AUTO_TEST_CASE(test_simd_kernels) {
+    vector<SimdLevel> levels(1, SimdLevel::Scalar);
+    if (DetectSimdLevel() != SimdLevel::Scalar) {
+        levels.push_back(SimdLevel::Avx2);
+    }
+    if (DetectSimdLevel() == SimdLevel::Avx512) {
+        levels.push_back(SimdLevel::Avx512);
+    }
+    for (size_t index = 0; index < levels.size(); ++index) {
+        check_simd_kernels<int>(levels[index]);
+        check_simd_kernels<long long>(levels[index]);
+        check_simd_kernels<float>(levels[index]);
+        check_simd_kernels<double>(levels[index]);
+    }
+
+    Polynomial<int> polynom = generate_polynom(3);
+    polynom += polynom * 2;
+    BOOST_CHECK_EQUAL(polynom, generate_polynom(3) * 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_normalized_degree) {
+    Polynomial<int> polynom = generate_polynom(3);
+    BOOST_CHECK_EQUAL(polynom[10], 0);
+    BOOST_CHECK_EQUAL(polynom.Degree(), 3);
+    polynom[3] = 0;
+    BOOST_CHECK_EQUAL(polynom.Degree(), 2);
+    polynom[2] -= 2;
+    BOOST_CHECK_EQUAL(polynom.Degree(), 1);
+    polynom[6] = 0;
+    BOOST_CHECK_EQUAL(polynom.Degree(), 1);
+    polynom[1] *= 0;
+    polynom[0] = polynom[1];
+    BOOST_CHECK_EQUAL(polynom.Degree(), 0);
+    BOOST_CHECK_EQUAL(polynom, Polynomial<int>());
+
+    vector<int> seq(4);
+    seq[3] = 7;
+    BOOST_CHECK_EQUAL(Polynomial<int>(seq.begin(), seq.end()).Degree(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_const_access) {
+    const Polynomial<int> first = generate_random_polynom<int>(300, 81, 100);
+    const Polynomial<int> second = generate_random_polynom<int>(200, 82, 100);
+    const Polynomial<int> expected_product = naive_product(first, second);
+    const Polynomial<int> expected_sum = naive_product(first, second) + first - second;
+    vector<int> points;
+    for (int point = -3; point <= 3; ++point) {
+        points.push_back(point);
+    }
+    const vector<int> expected_values = second.Evaluate(points);
+
+    std::atomic<int> mismatches(0);
+    vector<std::thread> workers;
+    for (int worker = 0; worker < 4; ++worker) {
+        workers.push_back(std::thread([&] {
+            for (int round = 0; round < 20; ++round) {
+                Polynomial<int> product = first * second;
+                Polynomial<int> sum = product + first - second;
+                if (product != expected_product || sum != expected_sum
+                    || second.Evaluate(points) != expected_values
+                    || first.Degree() != 300 || second[200] != 100 || !(second < first)) {
+                    ++mismatches;
+                }
+            }
+        }));
+    }
+    for (size_t index = 0; index < workers.size(); ++index) {
+        workers[index].join();
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+struct ParallelThresholdsGuard {
+    size_t multiply;
+    size_t evaluate;
+
+    ParallelThresholdsGuard(size_t new_multiply, size_t new_evaluate)
+        : multiply(ParallelThresholds::multiply), evaluate(ParallelThresholds::evaluate) {
+        ParallelThresholds::multiply = new_multiply;
+        ParallelThresholds::evaluate = new_evaluate;
+    }
+
+    ~ParallelThresholdsGuard() {
+        ParallelThresholds::multiply = multiply;
+        ParallelThresholds::evaluate = evaluate;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_parallel_multiply) {
+    ParallelThresholdsGuard guard(64, 256);
+    Polynomial<int> first = generate_random_polynom<int>(700, 91);
+    Polynomial<int> second = generate_random_polynom<int>(650, 92);
+    Polynomial<int> short_factor = generate_random_polynom<int>(40, 93);
+    BOOST_CHECK_EQUAL(Multiply(first, second, Execution::Parallel), first * second);
+    BOOST_CHECK_EQUAL(Multiply(first, short_factor, Execution::Parallel), naive_product(first, short_factor));
+    BOOST_CHECK_EQUAL(Multiply(short_factor, short_factor, Execution::Sequential), short_factor * short_factor);
+
+    // Buffers shared with the workers come from the caller's arena.
+    PolynomialArena arena(1 << 20);
+    Polynomial<int> arena_product, arena_blocks;
+    {
+        ArenaScope scope(arena);
+        arena_product = Multiply(first, second, Execution::Parallel);
+        arena_blocks = Multiply(first, short_factor, Execution::Parallel);
+    }
+    BOOST_CHECK_EQUAL(arena_product, first * second);
+    BOOST_CHECK_EQUAL(arena_blocks, naive_product(first, short_factor));
+
+    Polynomial<Residue> residue_first = generate_random_polynom<Residue>(500, 94);
+    Polynomial<Residue> residue_second = generate_random_polynom<Residue>(300, 95);
+    BOOST_CHECK(Multiply(residue_first, residue_second, Execution::Parallel) == residue_first * residue_second);
+
+    Polynomial<double> double_first = generate_random_polynom<double>(900, 96, 10);
+    Polynomial<double> double_second = generate_random_polynom<double>(800, 97, 10);
+    Polynomial<double> parallel = Multiply(double_first, double_second, Execution::Parallel);
+    BOOST_CHECK(Multiply(double_first, double_second, Execution::Parallel) == parallel);
+    Polynomial<double> sequential = double_first * double_second;
+    BOOST_REQUIRE_EQUAL(parallel.Degree(), sequential.Degree());
+    for (int i = 0; i <= sequential.Degree(); ++i) {
+        BOOST_CHECK_SMALL(parallel[i] - sequential[i], 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_evaluate) {
+    ParallelThresholdsGuard guard(64, 256);
+    Polynomial<double> polynom = generate_random_polynom<double>(30, 98, 10);
+    vector<double> points;
+    for (int point = 0; point < 5000; ++point) {
+        points.push_back((point % 200 - 100) / 64.0);
+    }
+    BOOST_CHECK(polynom.Evaluate(points, Execution::Parallel) == polynom.Evaluate(points));
+
+    Polynomial<int> small = generate_polynom(3);
+    BOOST_CHECK(small.Evaluate(vector<int>(3, 2), Execution::Parallel) == vector<int>(3, small(2)));
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool) {
+    ThreadPool pool(4);
+    vector<int> sums(16);
+    pool.ParallelFor(sums.size(), [&](size_t outer) {
+        vector<int> parts(8);
+        pool.ParallelFor(parts.size(), [&](size_t inner) {
+            parts[inner] = static_cast<int>(outer * inner);
+        });
+        for (size_t index = 0; index < parts.size(); ++index) {
+            sums[outer] += parts[index];
+        }
+    });
+    for (size_t outer = 0; outer < sums.size(); ++outer) {
+        BOOST_CHECK_EQUAL(sums[outer], static_cast<int>(28 * outer));
+    }
+
+    BOOST_CHECK_THROW(pool.ParallelFor(10, [](size_t index) {
+        if (index == 7) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_sparse_conversions) {
+    SparsePolynomial<int> sparse(vector<SparsePolynomial<int>::Term>{{1000000, 1}, {0, 1}, {5, 0}});
+    BOOST_CHECK_EQUAL(sparse.TermCount(), 2);
+    BOOST_CHECK_EQUAL(sparse.Degree(), 1000000);
+    BOOST_CHECK_EQUAL(sparse[1000000], 1);
+    BOOST_CHECK_EQUAL(sparse[5], 0);
+    BOOST_CHECK(sparse.PreferredRepresentation() == Representation::Sparse);
+    BOOST_CHECK_EQUAL(sparse(1), 2);
+    BOOST_CHECK_EQUAL(sparse(-1), 2);
+
+    Polynomial<int> dense = generate_polynom(4);
+    SparsePolynomial<int> converted(dense);
+    BOOST_CHECK_EQUAL(converted.TermCount(), 5);
+    BOOST_CHECK(converted.PreferredRepresentation() == Representation::Dense);
+    BOOST_CHECK_EQUAL(converted.ToDense(), dense);
+    BOOST_CHECK_EQUAL(SparsePolynomial<int>().ToDense(), Polynomial<int>());
+
+    converted.Set(2, 0);
+    converted.Set(7, 9);
+    std::stringstream stream;
+    stream << converted;
+    BOOST_CHECK_EQUAL(stream.str(), "9x^7 + x^4 + 2x^3 + 4x + 5");
+
+    BOOST_CHECK(ChooseRepresentation(3, 99) == Representation::Sparse);
+    BOOST_CHECK(ChooseRepresentation(10, 99) == Representation::Dense);
+}
+
+BOOST_AUTO_TEST_CASE(test_sparse_arithmetic) {
+    SparsePolynomial<int> plus(vector<SparsePolynomial<int>::Term>{{1000000, 1}, {0, 1}});
+    SparsePolynomial<int> minus(vector<SparsePolynomial<int>::Term>{{1000000, 1}, {0, -1}});
+    SparsePolynomial<int> product = plus * minus;
+    BOOST_CHECK(product == SparsePolynomial<int>(vector<SparsePolynomial<int>::Term>{{2000000, 1}, {0, -1}}));
+    BOOST_CHECK(product / plus == minus);
+    BOOST_CHECK(product % plus == SparsePolynomial<int>());
+    BOOST_CHECK(plus + minus == SparsePolynomial<int>(vector<SparsePolynomial<int>::Term>{{1000000, 2}}));
+    BOOST_CHECK(plus - plus == SparsePolynomial<int>());
+    BOOST_CHECK_THROW(plus / SparsePolynomial<int>(), std::overflow_error);
+
+    for (unsigned seed = 0; seed < 10; ++seed) {
+        SparsePolynomial<int> first = generate_sparse_polynom<int>(12, 300, 2 * seed);
+        SparsePolynomial<int> second = generate_sparse_polynom<int>(8, 200, 2 * seed + 1);
+        BOOST_CHECK_EQUAL((first * second).ToDense(), first.ToDense() * second.ToDense());
+        BOOST_CHECK_EQUAL((first + second).ToDense(), first.ToDense() + second.ToDense());
+        BOOST_CHECK_EQUAL((first - second).ToDense(), first.ToDense() - second.ToDense());
+        BOOST_CHECK_EQUAL(first(-1), first.ToDense()(-1));
+
+        SparsePolynomial<int> remainder = generate_sparse_polynom<int>(5, 150, 3 * seed);
+        SparsePolynomial<int> quotient, mod;
+        (first * second + remainder).RawDivide(second, quotient, mod);
+        BOOST_CHECK(quotient == first);
+        BOOST_CHECK(mod == remainder);
+    }
+
+    SparsePolynomial<Residue> dividend = generate_sparse_polynom<Residue>(20, 500, 71);
+    SparsePolynomial<Residue> divisor = generate_sparse_polynom<Residue>(6, 120, 72);
+    divisor.Set(120, Residue(17));
+    SparsePolynomial<Residue> quotient, mod;
+    dividend.RawDivide(divisor, quotient, mod);
+    BOOST_CHECK(quotient * divisor + mod == dividend);
+    BOOST_CHECK(mod.Degree() < divisor.Degree());
+    BOOST_CHECK(quotient.ToDense() == dividend.ToDense() / divisor.ToDense());
+
+    SparseThresholds::fill_ratio = 1.1;
+    SparsePolynomial<int> dense_first(generate_polynom(30));
+    SparsePolynomial<int> dense_second(generate_polynom(20));
+    BOOST_CHECK_EQUAL((dense_first * dense_second).ToDense(), generate_polynom(30) * generate_polynom(20));
+    SparseThresholds::fill_ratio = 0.1;
+}
+
+BOOST_AUTO_TEST_CASE(test_modint_arithmetic) {
+    typedef ModInt<998244353> Mod;
+    static_assert(Mod(3) * Mod(5) == Mod(15), "products are constexpr");
+    static_assert((Mod(7) / Mod(3)) * Mod(3) == Mod(7), "quotients are constexpr");
+    static_assert(Mod(-1).Value() == 998244352, "negative values wrap");
+
+    BOOST_CHECK_EQUAL(Mod(123456789) * Mod(987654321), Mod(123456789LL * 987654321LL % 998244353));
+    BOOST_CHECK_EQUAL(Mod(2).Power(23), Mod(1 << 23));
+    BOOST_CHECK_EQUAL(Mod(5) - Mod(7), Mod(-2));
+    BOOST_CHECK_EQUAL(-Mod(0), Mod(0));
+    BOOST_CHECK_THROW(Mod(1) / Mod(0), std::overflow_error);
+
+    std::stringstream stream;
+    vector<Mod> seq = {Mod(1), Mod(-1), Mod(0), Mod(5)};
+    stream << Polynomial<Mod>(seq.begin(), seq.end());
+    BOOST_CHECK_EQUAL(stream.str(), "x^3 + 998244352x^2 + 5");
+}
+
+BOOST_AUTO_TEST_CASE(test_modint_polynomial) {
+    typedef ModInt<998244353> Mod;
+    Polynomial<Mod> first = generate_random_polynom<Mod>(700, 81);
+    Polynomial<Mod> second = generate_random_polynom<Mod>(450, 82);
+    Polynomial<Mod> expected = naive_product(first, second);
+    BOOST_CHECK(first * second == expected);
+    {
+        ThresholdsGuard guard(16, 64);
+        MultiplicationThresholds::modular_ntt = 1u << 30;
+        BOOST_CHECK(first * second == expected);
+        MultiplicationThresholds::modular_ntt = 128;
+    }
+
+    Polynomial<Mod> remainder = generate_random_polynom<Mod>(300, 83);
+    Polynomial<Mod> dividend = expected + remainder;
+    BOOST_CHECK(dividend / second == first);
+    BOOST_CHECK(dividend % second == remainder);
+
+    typedef ModInt<1000003> Small;
+    Polynomial<Small> small_first = generate_random_polynom<Small>(600, 84);
+    Polynomial<Small> small_second = generate_random_polynom<Small>(500, 85);
+    BOOST_CHECK(small_first * small_second == naive_product(small_first, small_second));
+
+    // Modulo 3 the Toom-3 interpolation cannot divide by 3.
+    typedef ModInt<3> Three;
+    Polynomial<Three> three_first = generate_random_polynom<Three>(299, 87);
+    Polynomial<Three> three_second = generate_random_polynom<Three>(299, 88);
+    BOOST_CHECK(three_first * three_second == naive_product(three_first, three_second));
+    Polynomial<Three> three_shifted = TaylorShift(three_first, Three(1));
+    for (int point = 0; point < 3; ++point) {
+        BOOST_CHECK(three_shifted(Three(point)) == three_first(Three(point + 1)));
+    }
+
+    Polynomial<Mod> common = generate_random_polynom<Mod>(40, 86);
+    Polynomial<Mod> gcd = (common * first, common * second);
+    BOOST_CHECK_EQUAL(gcd.Degree(), 40);
+    BOOST_CHECK(monic(gcd) == monic(common));
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_allocations) {
+    Polynomial<Residue> common = generate_random_polynom<Residue>(30, 101);
+    Polynomial<Residue> first = common * generate_random_polynom<Residue>(300, 102);
+    Polynomial<Residue> second = common * generate_random_polynom<Residue>(280, 103);
+    Polynomial<Residue> expected_gcd = (first, second);
+    Polynomial<Residue> expected_quotient = first / second;
+
+    PolynomialArena arena(1 << 22);
+    Polynomial<Residue> gcd, quotient;
+    size_t count = count_allocations([&] {
+        ArenaScope scope(arena);
+        gcd = (first, second);
+        quotient = first / second;
+    });
+    BOOST_CHECK_EQUAL(count, 2u);
+    arena.Release();
+    BOOST_CHECK(gcd == expected_gcd);
+    BOOST_CHECK(quotient == expected_quotient);
+
+    {
+        ArenaScope scope(arena);
+        Polynomial<int> product = generate_polynom(200) * generate_polynom(300);
+        BOOST_CHECK_EQUAL(product, naive_product(generate_polynom(200), generate_polynom(300)));
+    }
+    BOOST_CHECK(ArenaScope::Current() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_small_buffer) {
+    vector<double> seq = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+    Polynomial<double> small(seq.begin(), seq.end());
+    Polynomial<double> other(seq.rbegin(), seq.rend());
+    Polynomial<double> result;
+    BOOST_CHECK_EQUAL(count_allocations([&] {
+        Polynomial<double> constant(2.5);
+        Polynomial<double> copy(small);
+        result = copy + other - constant;
+        result *= 2.0;
+    }), 0u);
+    BOOST_CHECK_EQUAL(result[8], 20.0);
+    BOOST_CHECK_EQUAL(result[0], 15.0);
+
+    Polynomial<double> grown(small);
+    grown[20] = 1.0;
+    grown.Shift(3);
+    BOOST_CHECK_EQUAL(grown.Degree(), 23);
+    BOOST_CHECK_EQUAL(grown[11], 1.0);
+    BOOST_CHECK_EQUAL(grown[3], 9.0);
+    Polynomial<double> moved(std::move(grown));
+    BOOST_CHECK_EQUAL(moved[23], 1.0);
+
+    Polynomial<string> words(string("x"));
+    Polynomial<string> words_copy(words);
+    words_copy[3] = "y";
+    BOOST_CHECK_EQUAL(words_copy.Degree(), 3);
+    BOOST_CHECK_EQUAL(words[0], "x");
+}
+
+BOOST_AUTO_TEST_CASE(test_static_polynomial) {
+    constexpr StaticPolynomial<int, 2> square(std::array<int, 3>{1, 2, 1});
+    constexpr StaticPolynomial<int, 1> linear(std::array<int, 2>{-1, 1});
+    constexpr StaticPolynomial<int, 3> product = square * linear;
+    static_assert(product(2) == 9, "evaluation is constexpr");
+    static_assert(product == StaticPolynomial<int, 3>(std::array<int, 4>{-1, -1, 1, 1}), "products are constexpr");
+    static_assert((square - square).Degree() == 0, "differences are constexpr");
+    static_assert(StaticPolynomial<int, 0>(7)(100) == 7, "constants are constexpr");
+
+    Polynomial<int> dense = generate_polynom(5);
+    StaticPolynomial<int, 7> converted(dense);
+    BOOST_CHECK_EQUAL(converted.Degree(), 5);
+    BOOST_CHECK_EQUAL(converted.ToPolynomial(), dense);
+    for (int point = -3; point <= 3; ++point) {
+        BOOST_CHECK_EQUAL(converted(point), dense(point));
+    }
+    BOOST_CHECK_THROW((StaticPolynomial<int, 4>(dense)), std::out_of_range);
+
+    StaticPolynomial<int, 5> other(generate_polynom(5));
+    BOOST_CHECK_EQUAL((converted * other).ToPolynomial(), dense * generate_polynom(5));
+    BOOST_CHECK_EQUAL((2 * converted + converted).ToPolynomial(), dense * Polynomial<int>(3));
+
+    std::stringstream stream;
+    stream << product;
+    BOOST_CHECK_EQUAL(stream.str(), "x^3 + x^2 - x - 1");
+}
+
+BOOST_AUTO_TEST_CASE(test_stats) {
+    PolynomialStats::Reset();
+    Polynomial<int> first = generate_polynom(10);
+    Polynomial<int> second = generate_polynom(100);
+    Polynomial<int> product = first * second;
+    Polynomial<int> quotient = product / first;
+    std::thread worker([&] {
+        Polynomial<int> square = second * second;
+    });
+    worker.join();
+    BOOST_CHECK_EQUAL(quotient, second);
+
+    PolynomialStats stats = PolynomialStats::Collect();
+    if (!PolynomialStats::enabled) {
+        BOOST_CHECK_EQUAL(stats[StatCounter::Multiplications], 0u);
+        return;
+    }
+    BOOST_CHECK_EQUAL(stats[StatCounter::Multiplications], 2u);
+    BOOST_CHECK_EQUAL(stats[StatCounter::Schoolbook], 1u);
+    BOOST_CHECK_EQUAL(stats[StatCounter::Karatsuba], 1u);
+    BOOST_CHECK_EQUAL(stats[StatCounter::Divisions], 1u);
+    BOOST_CHECK_EQUAL(stats[StatCounter::LongDivision], 1u);
+    BOOST_CHECK_GE(stats[StatCounter::CoefficientMultiplies], 11u * 101u + 101u * 11u);
+    BOOST_CHECK_GT(stats[StatCounter::Normalizations], 0u);
+    BOOST_CHECK_GT(stats[StatCounter::Allocations], 0u);
+
+    std::stringstream stream;
+    stream << stats;
+    BOOST_CHECK(stream.str().find("multiplications=2 ") != string::npos);
+
+    PolynomialStats::Reset();
+    BOOST_CHECK_EQUAL(PolynomialStats::Collect()[StatCounter::Multiplications], 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization) {
+    vector<double> seq = {0.1, -1e300, 3.5, 0, 1.0 / 3};
+    Polynomial<double> polynomial(seq.begin(), seq.end());
+    std::stringstream stream;
+    WritePolynomial(stream, polynomial);
+    BOOST_CHECK_EQUAL(stream.str().size(), 16u + 5 * sizeof(double));
+    BOOST_CHECK(ReadPolynomial<double>(stream) == polynomial);
+
+    Polynomial<long long> large = generate_random_polynom<long long>(1000, 104);
+    std::stringstream chunked;
+    PolynomialWriter<long long> writer(chunked, large.Degree());
+    for (int index = 0; index <= large.Degree(); index += 300) {
+        int count = std::min(300, large.Degree() + 1 - index);
+        writer.Write(&*large.begin() + index, count);
+    }
+    writer.Finish();
+    BOOST_CHECK_THROW(writer.Write(&*large.begin(), 1), std::out_of_range);
+
+    PolynomialReader<long long> reader(chunked);
+    BOOST_CHECK_EQUAL(reader.Degree(), 1000);
+    vector<long long> coefficients(1001);
+    size_t read = 0;
+    while (reader.Remaining() > 0) {
+        read += reader.Read(&coefficients[read], 256);
+    }
+    BOOST_CHECK_EQUAL(read, 1001u);
+    BOOST_CHECK_EQUAL(Polynomial<long long>(coefficients.rbegin(), coefficients.rend()), large);
+
+    string swapped = stream.str();
+    swapped[6] = swapped[6] == 1 ? 2 : 1;
+    std::reverse(swapped.begin() + 8, swapped.begin() + 16);
+    for (size_t offset = 16; offset < swapped.size(); offset += sizeof(double)) {
+        std::reverse(swapped.begin() + offset, swapped.begin() + offset + sizeof(double));
+    }
+    std::stringstream swapped_stream(swapped);
+    BOOST_CHECK(ReadPolynomial<double>(swapped_stream) == polynomial);
+
+    std::stringstream mismatched(stream.str());
+    BOOST_CHECK_THROW(ReadPolynomial<int>(mismatched), std::invalid_argument);
+    std::stringstream truncated(stream.str().substr(0, 30));
+    BOOST_CHECK_THROW(ReadPolynomial<double>(truncated), std::invalid_argument);
+
+    // A header that promises 2^30 coefficients is not trusted with the buffer.
+    string hostile = stream.str();
+    unsigned long long huge_degree = (1ull << 30) - 1;
+    std::memcpy(&hostile[8], &huge_degree, sizeof(huge_degree));
+    std::stringstream hostile_stream(hostile);
+    size_t bytes_before = allocated_bytes;
+    BOOST_CHECK_THROW(ReadPolynomial<double>(hostile_stream), std::invalid_argument);
+    BOOST_CHECK_LT(allocated_bytes - bytes_before, 1u << 20);
+
+#ifdef POLYNOMIAL_HAS_MMAP
+    const string path = "polynomial_view_test.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        WritePolynomial(file, large);
+    }
+    {
+        PolynomialView<long long> view(path);
+        BOOST_CHECK_EQUAL(view.Degree(), 1000);
+        BOOST_CHECK_EQUAL(view[1000], large[1000]);
+        BOOST_CHECK_THROW(view[1001], std::out_of_range);
+        BOOST_CHECK_EQUAL(view(-1), large(-1));
+        vector<long long> points = {-1, 0, 1};
+        vector<long long> values(points.size());
+        view.Evaluate(&points[0], points.size(), &values[0]);
+        BOOST_CHECK(values == large.Evaluate(points));
+        BOOST_CHECK_EQUAL(view.ToPolynomial(), large);
+        BOOST_CHECK_THROW((PolynomialView<double>(path)), std::invalid_argument);
+    }
+    std::remove(path.c_str());
+    BOOST_CHECK_THROW((PolynomialView<long long>(path)), std::runtime_error);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_text_format) {
+    vector<Polynomial<int> > polynomials = {Polynomial<int>(), Polynomial<int>(-7), generate_polynom(12)};
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        polynomials.push_back(generate_random_polynom<int>(seed, 200 + seed, 3));
+        polynomials.back()[seed + 1] = -1;
+    }
+    for (const Polynomial<int>& polynomial : polynomials) {
+        std::stringstream stream;
+        stream << polynomial;
+        BOOST_CHECK_EQUAL(FormatPolynomial(polynomial), stream.str());
+        BOOST_CHECK_EQUAL(ParsePolynomial<int>(stream.str()), polynomial);
+    }
+
+    vector<double> seq = {0.1, -1e300, 2.5, 0, 1.0 / 3};
+    Polynomial<double> real(seq.begin(), seq.end());
+    BOOST_CHECK(ParsePolynomial<double>(FormatPolynomial(real)) == real);
+    BOOST_CHECK_EQUAL(FormatPolynomial(ParsePolynomial<double>("2.5x^2 - x + 0.125")), "2.5x^2 - x + 0.125");
+
+    BOOST_CHECK_EQUAL(ParsePolynomial<int>(" x^2+x^2 - 3 * x+2 "), ParsePolynomial<int>("2x^2 - 3x + 2"));
+    BOOST_CHECK_EQUAL(ParsePolynomial<long long>("5 - x^3"), ParsePolynomial<long long>(" - x^3 + 5"));
+    BOOST_CHECK_EQUAL(ParsePolynomial<int>("x - x"), Polynomial<int>());
+    for (const char* text : {"", "+", "3y", "x^", "2 * 3", "x + 1 +"}) {
+        BOOST_CHECK_THROW(ParsePolynomial<int>(text), std::invalid_argument);
+    }
+
+    string text = "3x + 1, x - 2";
+    Polynomial<int> parsed;
+    std::from_chars_result result = ParsePolynomial(text.data(), text.data() + text.size(), parsed);
+    BOOST_CHECK(result.ec == std::errc());
+    BOOST_CHECK_EQUAL(result.ptr - text.data(), 6);
+    BOOST_CHECK_EQUAL(parsed, ParsePolynomial<int>("3x + 1"));
+    result = ParsePolynomial(text.data() + 6, text.data() + text.size(), parsed);
+    BOOST_CHECK(result.ec == std::errc::invalid_argument);
+    BOOST_CHECK_EQUAL(parsed, ParsePolynomial<int>("3x + 1"));
+
+    string huge = "x^2000000000";
+    size_t bytes_before = allocated_bytes;
+    result = ParsePolynomial(huge.data(), huge.data() + huge.size(), parsed);
+    BOOST_CHECK(result.ec == std::errc::result_out_of_range);
+    BOOST_CHECK(result.ptr == huge.data());
+    BOOST_CHECK_LT(allocated_bytes - bytes_before, 1u << 20);
+    BOOST_CHECK_EQUAL(ParsePolynomial<int>("x^1048576 + 1").Degree(), 1 << 20);
+    BOOST_CHECK_THROW(ParsePolynomial<int>("x^1048577"), std::invalid_argument);
+
+    char buffer[8];
+    BOOST_CHECK(FormatPolynomial(buffer, buffer + sizeof(buffer), generate_polynom(5)).ec == std::errc::value_too_large);
+    std::to_chars_result written = FormatPolynomial(buffer, buffer + sizeof(buffer), ParsePolynomial<int>("x^2 - 1"));
+    BOOST_CHECK(written.ec == std::errc());
+    BOOST_CHECK_EQUAL(string(buffer, written.ptr), "x^2 - 1");
+
+    std::stringstream input("x^3 - 2x\n - 4\nx +\n");
+    Polynomial<int> first, second, third;
+    input >> first >> second;
+    BOOST_CHECK_EQUAL(first, ParsePolynomial<int>("x^3 - 2x"));
+    BOOST_CHECK_EQUAL(second, Polynomial<int>(-4));
+    BOOST_CHECK(!(input >> third));
+}
+
+BOOST_AUTO_TEST_CASE(test_composition) {
+    Polynomial<int> outer = ParsePolynomial<int>("x^2 - 3x + 1");
+    Polynomial<int> inner = ParsePolynomial<int>("2x + 5");
+    BOOST_CHECK_EQUAL(Compose(outer, inner), ParsePolynomial<int>("4x^2 + 14x + 11"));
+    BOOST_CHECK_EQUAL(Compose(outer, Polynomial<int>(2)), Polynomial<int>(-1));
+    BOOST_CHECK_EQUAL(Compose(Polynomial<int>(7), inner), Polynomial<int>(7));
+    BOOST_CHECK_EQUAL(TaylorShift(outer, 2), ParsePolynomial<int>("x^2 + x - 1"));
+
+    Polynomial<Residue> big_outer = generate_random_polynom<Residue>(100, 301);
+    Polynomial<Residue> big_inner = generate_random_polynom<Residue>(7, 302);
+    Polynomial<Residue> expected(big_outer[100]);
+    for (int index = 99; index >= 0; --index) {
+        expected = expected * big_inner + Polynomial<Residue>(big_outer[index]);
+    }
+    BOOST_CHECK(Compose(big_outer, big_inner) == expected);
+
+    vector<Residue> linear = {Residue(1), Residue(-3)};
+    Polynomial<Residue> shift_inner(linear.begin(), linear.end());
+    for (int degree : {10, 200}) {
+        Polynomial<Residue> polynomial = generate_random_polynom<Residue>(degree, 303 + degree);
+        Polynomial<Residue> shifted = TaylorShift(polynomial, Residue(-3));
+        BOOST_CHECK(shifted == Compose(polynomial, shift_inner));
+        BOOST_CHECK(shifted(Residue(5)) == polynomial(Residue(2)));
+    }
+
+    size_t taylor_shift = CompositionThresholds::taylor_shift;
+    Polynomial<long long> integers = generate_random_polynom<long long>(40, 305, 5);
+    for (size_t threshold : {size_t(64), size_t(8)}) {
+        CompositionThresholds::taylor_shift = threshold;
+        Polynomial<long long> shifted = TaylorShift(integers, 1LL);
+        BOOST_CHECK_EQUAL(shifted(0), integers(1));
+        BOOST_CHECK_EQUAL(TaylorShift(shifted, -1LL), integers);
+    }
+    CompositionThresholds::taylor_shift = taylor_shift;
+}
+
+BOOST_AUTO_TEST_CASE(test_interpolation) {
+    vector<double> points = {-2, 0, 1, 3};
+    vector<double> values = {-3, 1, 0, 22};
+    Polynomial<double> cubic = Interpolate(points, values);
+    Polynomial<double> expected = ParsePolynomial<double>("x^3 - 2x + 1");
+    BOOST_CHECK_EQUAL(cubic.Degree(), 3);
+    for (int index = 0; index <= 3; ++index) {
+        BOOST_CHECK_SMALL(cubic[index] - expected[index], 1e-12);
+    }
+    BOOST_CHECK_EQUAL(Interpolate(vector<double>{4}, vector<double>{2}), Polynomial<double>(2));
+    BOOST_CHECK_EQUAL(Interpolate(vector<double>(), vector<double>()), Polynomial<double>());
+    BOOST_CHECK_THROW(Interpolate(points, vector<double>{1, 2}), std::invalid_argument);
+    BOOST_CHECK_THROW(Interpolate(vector<double>{1, 1}, vector<double>{1, 2}), std::invalid_argument);
+
+    size_t subproduct_tree = InterpolationThresholds::subproduct_tree;
+    for (int degree : {30, 700}) {
+        Polynomial<Residue> polynomial = generate_random_polynom<Residue>(degree, 400 + degree);
+        vector<Residue> residue_points, residue_values;
+        for (int index = 0; index <= degree; ++index) {
+            residue_points.push_back(Residue(3 * index - degree));
+            residue_values.push_back(polynomial(residue_points.back()));
+        }
+        for (size_t threshold : {size_t(1), size_t(100000)}) {
+            InterpolationThresholds::subproduct_tree = threshold;
+            BOOST_CHECK(Interpolate(residue_points, residue_values) == polynomial);
+        }
+        residue_points[degree / 2] = residue_points[0];
+        BOOST_CHECK_THROW(Interpolate(residue_points, residue_values), std::invalid_argument);
+    }
+    InterpolationThresholds::subproduct_tree = subproduct_tree;
+}
+
+BOOST_AUTO_TEST_CASE(test_polynomial_batch) {
+    vector<Polynomial<long long> > lhs, rhs, divisors;
+    vector<long long> points;
+    for (unsigned index = 0; index < 37; ++index) {
+        lhs.push_back(generate_random_polynom<long long>(2 + index % 5, 500 + index));
+        rhs.push_back(generate_random_polynom<long long>(index % 4, 600 + index));
+        divisors.push_back(generate_random_polynom<long long>(2, 700 + index));
+        divisors.back()[2] = 1;
+        points.push_back(static_cast<long long>(index % 5) - 2);
+    }
+    PolynomialBatch<long long> lhs_batch(lhs), rhs_batch(rhs), divisor_batch(divisors);
+    BOOST_CHECK_EQUAL(lhs_batch.Size(), 37u);
+    BOOST_CHECK_EQUAL(lhs_batch.Degree(), 6);
+
+    PolynomialBatch<long long> sum = lhs_batch + rhs_batch;
+    PolynomialBatch<long long> difference = lhs_batch - rhs_batch;
+    PolynomialBatch<long long> product = lhs_batch * rhs_batch;
+    PolynomialBatch<long long> quotient(0, 0), remainder(0, 0);
+    product.DivideByMonic(divisor_batch, quotient, remainder);
+    vector<long long> values = product.Evaluate(points);
+    BOOST_CHECK_EQUAL(remainder.Degree(), 1);
+    for (size_t index = 0; index < lhs.size(); ++index) {
+        BOOST_CHECK_EQUAL(sum[index], lhs[index] + rhs[index]);
+        BOOST_CHECK_EQUAL(difference[index], lhs[index] - rhs[index]);
+        BOOST_CHECK_EQUAL(product[index], lhs[index] * rhs[index]);
+        BOOST_CHECK_EQUAL(values[index], (lhs[index] * rhs[index])(points[index]));
+        BOOST_CHECK_EQUAL(quotient[index], lhs[index] * rhs[index] / divisors[index]);
+        BOOST_CHECK_EQUAL(remainder[index], lhs[index] * rhs[index] % divisors[index]);
+    }
+    BOOST_CHECK(sum - rhs_batch == lhs_batch);
+    BOOST_CHECK(sum != lhs_batch);
+    BOOST_CHECK_THROW(lhs_batch.DivideByMonic(lhs_batch, quotient, remainder), std::invalid_argument);
+    BOOST_CHECK_THROW(lhs_batch + PolynomialBatch<long long>(3, 1), std::invalid_argument);
+    BOOST_CHECK_THROW(lhs_batch.Set(0, generate_random_polynom<long long>(7, 1)), std::out_of_range);
+
+    vector<double> seq = {0.5, -1, 0.25};
+    PolynomialBatch<double> reals(3, 2);
+    reals.Set(1, Polynomial<double>(seq.begin(), seq.end()));
+    reals(2, 0) = 4;
+    vector<double> real_values = reals.Evaluate(vector<double>{1, 2, 3});
+    BOOST_CHECK_EQUAL(real_values[0], 0.0);
+    BOOST_CHECK_EQUAL(real_values[1], 0.5 * 4 - 2 + 0.25);
+    BOOST_CHECK_EQUAL(real_values[2], 4.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_roots) {
+    Polynomial<int> cubic = ParsePolynomial<int>("x^3 - 2x^2 - 5x + 6");
+    BOOST_CHECK_EQUAL(cubic.Derivative(), ParsePolynomial<int>("3x^2 - 4x - 5"));
+    BOOST_CHECK_EQUAL(Polynomial<int>(7).Derivative(), Polynomial<int>());
+
+    vector<RootInterval> intervals = IsolateRealRoots(cubic);
+    BOOST_REQUIRE_EQUAL(intervals.size(), 3u);
+    double expected[] = {-2, 1, 3};
+    for (size_t index = 0; index < 3; ++index) {
+        BOOST_CHECK(intervals[index].lower <= expected[index] && expected[index] <= intervals[index].upper);
+    }
+    for (Execution execution : {Execution::Sequential, Execution::Parallel}) {
+        vector<double> roots = RealRoots(cubic, execution);
+        BOOST_REQUIRE_EQUAL(roots.size(), 3u);
+        for (size_t index = 0; index < 3; ++index) {
+            BOOST_CHECK_CLOSE(roots[index], expected[index], 1e-9);
+        }
+    }
+
+    // Repeated, zero, irrational and close roots: x^2 (x - 1)^3 (x^2 - 2) (10x - 7) (10x - 8).
+    Polynomial<long long> hard = ParsePolynomial<long long>("x^2") * ParsePolynomial<long long>("x - 1")
+        * ParsePolynomial<long long>("x - 1") * ParsePolynomial<long long>("x - 1")
+        * ParsePolynomial<long long>("x^2 - 2") * ParsePolynomial<long long>("10x - 7")
+        * ParsePolynomial<long long>("10x - 8");
+    vector<double> hard_roots = RealRoots(hard);
+    double hard_expected[] = {-std::sqrt(2.0), 0, 0.7, 0.8, 1, std::sqrt(2.0)};
+    BOOST_REQUIRE_EQUAL(hard_roots.size(), 6u);
+    for (size_t index = 0; index < 6; ++index) {
+        BOOST_CHECK_SMALL(hard_roots[index] - hard_expected[index], 1e-12);
+    }
+    BOOST_CHECK(RealRoots(ParsePolynomial<int>("x^2 + 1")).empty());
+    BOOST_CHECK_THROW(IsolateRealRoots(Polynomial<int>()), std::invalid_argument);
+
+    size_t parallel_refine = RootThresholds::parallel_refine;
+    RootThresholds::parallel_refine = 1;
+    Polynomial<long long> many(1);
+    for (int root = -6; root <= 6; ++root) {
+        vector<long long> factor = {1, -root};
+        many *= Polynomial<long long>(factor.begin(), factor.end());
+    }
+    vector<double> many_roots = RealRoots(many, Execution::Parallel);
+    BOOST_REQUIRE_EQUAL(many_roots.size(), 13u);
+    for (int root = -6; root <= 6; ++root) {
+        BOOST_CHECK_SMALL(many_roots[root + 6] - root, 1e-9);
+    }
+    RootThresholds::parallel_refine = parallel_refine;
+
+    // Small coefficients, but far more growth during bisection than 128 bits hold.
+    Polynomial<long long> wide = generate_random_polynom<long long>(60, 23, 5);
+    vector<RootInterval> wide_intervals;
+    BOOST_REQUIRE_NO_THROW(wide_intervals = IsolateRealRoots(wide));
+    vector<double> wide_roots = RealRoots(wide);
+    BOOST_REQUIRE_EQUAL(wide_roots.size(), wide_intervals.size());
+    for (size_t index = 0; index < wide_roots.size(); ++index) {
+        BOOST_CHECK(wide_intervals[index].lower <= wide_roots[index] && wide_roots[index] <= wide_intervals[index].upper);
+        double value = 0, scale = 0;
+        for (int power = wide.Degree(); power >= 0; --power) {
+            value = value * wide_roots[index] + static_cast<double>(wide[power]);
+            scale = scale * std::abs(wide_roots[index]) + std::abs(static_cast<double>(wide[power]));
+        }
+        BOOST_CHECK_SMALL(value / scale, 1e-12);
+    }
+
+    vector<std::complex<double> > complex_roots = ComplexRoots(ParsePolynomial<double>("x^4 - 3x^3 + 3x^2 - 3x + 2"));
+    std::complex<double> complex_expected[] = {{0, -1}, {0, 1}, {1, 0}, {2, 0}};
+    BOOST_REQUIRE_EQUAL(complex_roots.size(), 4u);
+    for (const std::complex<double>& expected_root : complex_expected) {
+        double distance = 1;
+        for (const std::complex<double>& root : complex_roots) {
+            distance = std::min(distance, std::abs(root - expected_root));
+        }
+        BOOST_CHECK_SMALL(distance, 1e-12);
+    }
+    const Polynomial<double> random = generate_random_polynom<double>(200, 900);
+    for (const std::complex<double>& root : ComplexRoots(random)) {
+        double scale = 0;
+        for (int index = 0; index <= random.Degree(); ++index) {
+            scale += std::abs(random[index]) * std::pow(std::abs(root), index);
+        }
+        std::complex<double> value = 0;
+        for (int index = random.Degree(); index >= 0; --index) {
+            value = value * root + random[index];
+        }
+        BOOST_CHECK_SMALL(std::abs(value) / scale, 1e-12);
+    }
+    BOOST_CHECK_THROW(ComplexRoots(Polynomial<double>()), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_big_int) {
+    BigInt large("-123456789012345678901234567890");
+    BOOST_CHECK_EQUAL(large.ToString(), "-123456789012345678901234567890");
+    BOOST_CHECK_EQUAL((-large).ToString(), "123456789012345678901234567890");
+    BOOST_CHECK_EQUAL(BigInt("-0"), BigInt());
+    BOOST_CHECK_EQUAL((large * large / large).ToString(), large.ToString());
+    BOOST_CHECK_EQUAL((large * large + BigInt(17)) % large, BigInt(17));
+    BOOST_CHECK(large < BigInt() && BigInt() < -large && large * large > -large);
+    BOOST_CHECK_THROW(BigInt("12a"), std::invalid_argument);
+    BOOST_CHECK_THROW(BigInt("-"), std::invalid_argument);
+    BOOST_CHECK_THROW(large / BigInt(), std::overflow_error);
+
+    std::mt19937_64 generator(11);
+    for (int step = 0; step < 1000; ++step) {
+        long long lhs = static_cast<long long>(generator() >> 2) - (1LL << 61);
+        long long rhs = static_cast<long long>(generator() >> (2 + step % 60)) - (1LL << (61 - step % 60));
+        if (rhs == 0) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(BigInt(lhs) + BigInt(rhs), BigInt(lhs + rhs));
+        BOOST_CHECK_EQUAL(BigInt(lhs) - BigInt(rhs), BigInt(lhs - rhs));
+        BOOST_CHECK_EQUAL(BigInt(lhs) / BigInt(rhs), BigInt(lhs / rhs));
+        BOOST_CHECK_EQUAL(BigInt(lhs) % BigInt(rhs), BigInt(lhs % rhs));
+        BOOST_CHECK_EQUAL(BigInt(lhs) < BigInt(rhs), lhs < rhs);
+        BigInt product = BigInt(lhs) * BigInt(rhs) * BigInt(lhs);
+        BOOST_CHECK_EQUAL(product / (BigInt(lhs) * BigInt(rhs)), BigInt(lhs));
+        BOOST_CHECK_EQUAL(product.Modulo(998244353), (lhs % 998244353 + 998244353) % 998244353
+            * ((rhs % 998244353 + 998244353) % 998244353) % 998244353 * ((lhs % 998244353 + 998244353) % 998244353)
+            % 998244353);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_modular) {
+    auto random_big = [](int degree, unsigned seed, int digits) {
+        std::mt19937 generator(seed);
+        vector<BigInt> seq;
+        for (int i = 0; i <= degree; ++i) {
+            std::string text = i > 0 && generator() % 2 ? "-" : "";
+            for (int digit = 0; digit < digits; ++digit) {
+                text.push_back(static_cast<char>('1' + generator() % 9));
+            }
+            seq.push_back(BigInt(text));
+        }
+        seq.back() = BigInt(1);
+        return Polynomial<BigInt>(seq.begin(), seq.end());
+    };
+
+    size_t multi_modular = MultiplicationThresholds::multi_modular;
+    size_t parallel_primes = MultiModularThresholds::parallel_primes;
+    for (int degree : {4, 40, 130}) {
+        Polynomial<BigInt> lhs = random_big(degree, 10 + degree, 60);
+        Polynomial<BigInt> rhs = random_big(degree / 2 + 1, 20 + degree, 25);
+        Polynomial<BigInt> required = naive_product(lhs, rhs);
+        for (size_t threshold : {size_t(1), size_t(100000)}) {
+            MultiplicationThresholds::multi_modular = threshold;
+            for (size_t primes : {size_t(1), size_t(100000)}) {
+                MultiModularThresholds::parallel_primes = primes;
+                BOOST_CHECK_EQUAL(lhs * rhs, required);
+            }
+        }
+    }
+    MultiplicationThresholds::multi_modular = multi_modular;
+    MultiModularThresholds::parallel_primes = parallel_primes;
+
+    Polynomial<BigInt> common = random_big(6, 1, 30);
+    Polynomial<BigInt> first = random_big(25, 2, 30);
+    Polynomial<BigInt> second = random_big(17, 3, 30);
+    BOOST_CHECK_EQUAL((first, second), Polynomial<BigInt>(1));
+    BOOST_CHECK_EQUAL((first * common, second * common), common);
+    BOOST_CHECK_EQUAL((first * common * BigInt(6), second * common * BigInt(-4)), common * BigInt(2));
+    BOOST_CHECK_EQUAL((first * common * common, second * common), common);
+    Polynomial<BigInt> first_multiple = first * common;
+    Polynomial<BigInt> second_multiple = second * common;
+    ArenaVector<BigInt> reference = PrimitiveGcd(ArenaVector<BigInt>(first_multiple.begin(), first_multiple.end() + 1),
+                                                 ArenaVector<BigInt>(second_multiple.begin(), second_multiple.end() + 1));
+    if (reference.back() < BigInt()) {
+        for (BigInt& coef : reference) {
+            coef = -coef;
+        }
+    }
+    BOOST_CHECK_EQUAL((first_multiple, second_multiple), Polynomial<BigInt>(reference.rbegin(), reference.rend()));
+    BOOST_CHECK_EQUAL((first * common, Polynomial<BigInt>()), first * common);
+
+    // Exact root isolation no longer runs out of bits: (x - 1)(x - 2)...(x - 30).
+    Polynomial<BigInt> factorial(1);
+    for (int root = 1; root <= 30; ++root) {
+        vector<BigInt> factor = {BigInt(1), BigInt(-root)};
+        factorial *= Polynomial<BigInt>(factor.begin(), factor.end());
+    }
+    vector<double> roots = RealRoots(factorial);
+    BOOST_REQUIRE_EQUAL(roots.size(), 30u);
+    for (int root = 1; root <= 30; ++root) {
+        BOOST_CHECK_CLOSE(roots[root - 1], root, 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cached_polynomial) {
+    typedef ModInt<998244353> Mod;
+    vector<Mod> fixed_points = {Mod(2), Mod(-3), Mod(12345)};
+    CachedPolynomial<Mod> cached(generate_random_polynom<Mod>(40, 91), fixed_points, 4);
+    std::mt19937 generator(92);
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    for (int step = 0; step < 300; ++step) {
+        size_t index = static_cast<size_t>(distribution(generator) + 1000) % 60;
+        Mod point(distribution(generator) % 7);
+        if (step % 3 == 0) {
+            cached[index] = Mod(distribution(generator));
+        } else if (step % 3 == 1) {
+            cached[index] += Mod(distribution(generator));
+        } else {
+            cached[index] *= Mod(distribution(generator));
+        }
+        const Polynomial<Mod> current = cached.Snapshot();
+        BOOST_CHECK(cached(point) == current(point));
+        BOOST_CHECK(static_cast<Mod>(cached[index]) == (index > static_cast<size_t>(current.Degree()) ? Mod(0) : current[index]));
+        for (size_t fixed = 0; fixed < fixed_points.size(); ++fixed) {
+            BOOST_CHECK(cached.Value(fixed) == current(fixed_points[fixed]));
+        }
+    }
+    BOOST_CHECK_EQUAL(cached.CachedPoints(), 4u);
+    BOOST_CHECK_THROW(cached.Value(3), std::out_of_range);
+    CachedPolynomial<Mod> lookup(generate_random_polynom<Mod>(10, 94), fixed_points, 4);
+    BOOST_CHECK(lookup(fixed_points[0]) == lookup.Value(0));
+    BOOST_CHECK_EQUAL(lookup.CachedPoints(), 0u);
+    const CachedPolynomial<Mod>& view = lookup;
+    BOOST_CHECK(view[10] == lookup.Snapshot()[10]);
+    BOOST_CHECK(view[100] == Mod(0));
+
+    cached.Assign(Polynomial<Mod>(Mod(5)));
+    BOOST_CHECK_EQUAL(cached.Degree(), 0);
+    BOOST_CHECK(cached.Values() == vector<Mod>(3, Mod(5)));
+    cached[3] = Mod(1);
+    BOOST_CHECK(cached.Value(1) == Mod(5) + Mod(-27));
+    cached[3] = Mod(0);
+    BOOST_CHECK_EQUAL(cached.Degree(), 0);
+
+    CachedPolynomial<long long> shared(generate_random_polynom<long long>(30, 93, 10), 8);
+    std::atomic<bool> done(false);
+    vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&shared, &done, reader] {
+            for (long long point = reader; !done; point = (point + 1) % 5) {
+                shared(point - 2);
+            }
+        });
+    }
+    for (int step = 0; step < 500; ++step) {
+        shared[step % 31] += step % 5 - 2;
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    const Polynomial<long long> current = shared.Snapshot();
+    for (long long point = -2; point <= 2; ++point) {
+        BOOST_CHECK_EQUAL(shared(point), current(point));
+    }
+
+    vector<double> seq = {1, 0.5, -2};
+    CachedPolynomial<double> reals(Polynomial<double>(seq.begin(), seq.end()), vector<double>{0.1, 3});
+    reals[1] -= 0.25;
+    reals[4] = 1e-3;
+    BOOST_CHECK_CLOSE(reals.Value(0), reals.Snapshot()(0.1), 1e-12);
+    BOOST_CHECK_CLOSE(reals(-0.7), reals.Snapshot()(-0.7), 1e-12);
+    reals.Refresh();
+    BOOST_CHECK_EQUAL(reals.Value(1), reals.Snapshot()(3.0));
+}
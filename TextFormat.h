@@ -0,0 +1,46 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+
+#include "Polynomial.h"
+
+
+// Text in the syntax operator << produces, such as "3x^2 - x + 5" or
+// " - x^3 + 2", for integer and floating point coefficients. Numbers go
+// through std::from_chars and std::to_chars, so neither locale nor stream
+// state is involved. Terms may come in any order and repeat; spaces between
+// tokens and a '*' before x are optional.
+
+struct TextFormatThresholds {
+    // Exponents above this are std::errc::result_out_of_range: the parser
+    // stores coefficients densely, and a dozen characters such as
+    // "x^2000000000" must not make it allocate gigabytes.
+    static inline size_t max_degree = 1 << 20;
+};
+
+// Parses the longest polynomial at the start of [first, last) like
+// std::from_chars: on success ptr points past it, otherwise ec is set, ptr is
+// first and polynomial is left unchanged.
+template<class T>
+std::from_chars_result ParsePolynomial(const char* first, const char* last, Polynomial<T>& polynomial);
+
+// Throws std::invalid_argument unless the whole text is one polynomial.
+template<class T>
+Polynomial<T> ParsePolynomial(std::string_view text);
+
+// Writes the same characters as operator << for integer coefficients, and the
+// shortest exact representation for floating point ones. Like std::to_chars it
+// returns {last, std::errc::value_too_large} when the buffer is too small.
+template<class T>
+std::to_chars_result FormatPolynomial(char* first, char* last, const Polynomial<T>& polynomial);
+
+template<class T>
+std::string FormatPolynomial(const Polynomial<T>& polynomial);
+
+// Reads the rest of the line and sets failbit unless it is one polynomial.
+template<class T>
+std::istream& operator >>(std::istream&, Polynomial<T>&);
+
+#include "TextFormat.hpp"
@@ -0,0 +1,232 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+
+
+template<class T>
+void CheckTextCoefficient() {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "only integer and floating point coefficients have a text format");
+}
+
+inline const char* SkipSpaces(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r')) {
+        ++first;
+    }
+    return first;
+}
+
+inline bool IsDigit(char symbol) {
+    return symbol >= '0' && symbol <= '9';
+}
+
+// Parses one unsigned term: a number, x, x^n or a number followed by one of
+// them. The cursor is left right after the term.
+template<class T>
+std::errc ParseTerm(const char*& cursor, const char* last, T& coef, size_t& degree) {
+    coef = T(1);
+    degree = 0;
+    bool has_number = false;
+    if (cursor != last && (IsDigit(*cursor) || (std::is_floating_point<T>::value && *cursor == '.'))) {
+        std::from_chars_result result = std::from_chars(cursor, last, coef);
+        if (result.ec != std::errc()) {
+            return result.ec;
+        }
+        cursor = result.ptr;
+        has_number = true;
+    }
+
+    const char* next = SkipSpaces(cursor, last);
+    if (has_number && next != last && *next == '*') {
+        next = SkipSpaces(next + 1, last);
+        if (next == last || *next != 'x') {
+            return std::errc::invalid_argument;
+        }
+    }
+    if (next == last || *next != 'x') {
+        return has_number ? std::errc() : std::errc::invalid_argument;
+    }
+
+    cursor = next + 1;
+    degree = 1;
+    next = SkipSpaces(cursor, last);
+    if (next != last && *next == '^') {
+        next = SkipSpaces(next + 1, last);
+        std::from_chars_result result = std::from_chars(next, last, degree);
+        if (result.ec != std::errc()) {
+            return result.ec;
+        }
+        cursor = result.ptr;
+    }
+    return std::errc();
+}
+
+template<class T>
+std::from_chars_result ParsePolynomial(const char* first, const char* last, Polynomial<T>& polynomial) {
+    CheckTextCoefficient<T>();
+
+    PolynomialCoefficients<T> coefficients;
+    const char* cursor = SkipSpaces(first, last);
+    const char* end = first;
+    bool negative = false;
+    if (cursor != last && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        cursor = SkipSpaces(cursor + 1, last);
+    }
+
+    while (true) {
+        T coef;
+        size_t degree;
+        std::errc error = ParseTerm(cursor, last, coef, degree);
+        if (error == std::errc() && (degree > TextFormatThresholds::max_degree
+                                     || degree >= static_cast<size_t>(std::numeric_limits<int>::max()))) {
+            error = std::errc::result_out_of_range;
+        }
+        if (error != std::errc()) {
+            // A sign without a term after it ends the polynomial before the sign.
+            if (coefficients.empty() || error != std::errc::invalid_argument) {
+                return {first, error};
+            }
+            break;
+        }
+
+        if (degree >= coefficients.size()) {
+            coefficients.resize(degree + 1);
+        }
+        if (negative) {
+            coefficients[degree] -= coef;
+        } else {
+            coefficients[degree] += coef;
+        }
+        end = cursor;
+
+        const char* next = SkipSpaces(cursor, last);
+        if (next == last || (*next != '+' && *next != '-')) {
+            break;
+        }
+        negative = *next == '-';
+        cursor = SkipSpaces(next + 1, last);
+    }
+
+    polynomial = Polynomial<T>(std::make_reverse_iterator(coefficients.end()),
+                               std::make_reverse_iterator(coefficients.begin()));
+    return {end, std::errc()};
+}
+
+template<class T>
+Polynomial<T> ParsePolynomial(std::string_view text) {
+    Polynomial<T> polynomial;
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = ParsePolynomial(text.data(), last, polynomial);
+    if (result.ec != std::errc() || SkipSpaces(result.ptr, last) != last) {
+        throw std::invalid_argument("Cannot parse polynomial");
+    }
+    return polynomial;
+}
+
+inline bool AppendText(char*& cursor, char* last, const char* text, size_t size) {
+    if (static_cast<size_t>(last - cursor) < size) {
+        return false;
+    }
+    std::memcpy(cursor, text, size);
+    cursor += size;
+    return true;
+}
+
+// Writes value, without its minus sign when magnitude is set.
+template<class T>
+bool AppendNumber(char*& cursor, char* last, const T& value, bool magnitude) {
+    char digits[64];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    const char* begin = digits;
+    if (magnitude && *begin == '-') {
+        ++begin;
+    }
+    return AppendText(cursor, last, begin, result.ptr - begin);
+}
+
+// Same decisions as AddMonomial.
+template<class T>
+bool AppendMonomial(char*& cursor, char* last, const T& coef, size_t degree, bool is_first) {
+    if (coef == T() && degree == 0 && is_first) {
+        return AppendNumber(cursor, last, coef, false);
+    }
+
+    if (coef == T()) {
+        return true;
+    }
+
+    if (coef < T() && !AppendText(cursor, last, " - ", 3)) {
+        return false;
+    }
+
+    if (coef > T() && !is_first && !AppendText(cursor, last, " + ", 3)) {
+        return false;
+    }
+
+    if (degree == 0) {
+        return AppendNumber(cursor, last, coef, true);
+    }
+
+    if (coef != 1 && coef != -1 && !AppendNumber(cursor, last, coef, true)) {
+        return false;
+    }
+
+    if (!AppendText(cursor, last, "x", 1)) {
+        return false;
+    }
+    return degree == 1 || (AppendText(cursor, last, "^", 1) && AppendNumber(cursor, last, degree, false));
+}
+
+template<class T>
+std::to_chars_result FormatPolynomial(char* first, char* last, const Polynomial<T>& polynomial) {
+    CheckTextCoefficient<T>();
+
+    const T* coefficients = &*polynomial.begin();
+    size_t degree = polynomial.Degree();
+    char* cursor = first;
+    if (!AppendMonomial(cursor, last, coefficients[degree], degree, true)) {
+        return {last, std::errc::value_too_large};
+    }
+    for (size_t index = degree; index-- > 0;) {
+        if (!AppendMonomial(cursor, last, coefficients[index], index, false)) {
+            return {last, std::errc::value_too_large};
+        }
+    }
+    return {cursor, std::errc()};
+}
+
+template<class T>
+std::string FormatPolynomial(const Polynomial<T>& polynomial) {
+    std::string text(16 * (polynomial.Degree() + 1), '\0');
+    while (true) {
+        std::to_chars_result result = FormatPolynomial(&text[0], &text[0] + text.size(), polynomial);
+        if (result.ec == std::errc()) {
+            text.resize(result.ptr - &text[0]);
+            return text;
+        }
+        text.resize(2 * text.size());
+    }
+}
+
+template<class T>
+std::istream& operator >>(std::istream& stream, Polynomial<T>& polynomial) {
+    std::string line;
+    if (!std::getline(stream, line)) {
+        return stream;
+    }
+    const char* last = line.data() + line.size();
+    std::from_chars_result result = ParsePolynomial(line.data(), last, polynomial);
+    if (result.ec != std::errc() || SkipSpaces(result.ptr, last) != last) {
+        stream.setstate(std::ios::failbit);
+    }
+    return stream;
+}
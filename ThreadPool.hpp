@@ -0,0 +1,163 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstddef>
+
+using std::vector;
+
+
+// Fixed-size pool where every worker owns a deque of tasks. A worker pops the
+// newest task of its own deque and, when that is empty, steals the oldest task
+// of another one. A thread waiting in ParallelFor keeps running tasks instead
+// of blocking, so nested ParallelFor calls cannot deadlock the pool.
+class ThreadPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    vector<std::unique_ptr<Queue> > queues;
+    vector<std::thread> threads;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> next_queue;
+    bool stopping;
+
+    static inline thread_local ThreadPool* current_pool = 0;
+    static inline thread_local size_t current_queue = 0;
+
+    void Push(std::function<void()> task) {
+        size_t index = current_pool == this ? current_queue : next_queue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            ++pending;
+        }
+        wake.notify_one();
+    }
+
+    bool TryRunOne(size_t preferred) {
+        std::function<void()> task;
+        for (size_t offset = 0; offset < queues.size() && !task; ++offset) {
+            Queue& queue = *queues[(preferred + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (offset == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        --pending;
+        task();
+        return true;
+    }
+
+    void WorkerLoop(size_t index) {
+        current_pool = this;
+        current_queue = index;
+        while (true) {
+            if (TryRunOne(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t thread_count) : pending(0), next_queue(0), stopping(false) {
+        thread_count = std::max<size_t>(thread_count, 1);
+        for (size_t index = 0; index < thread_count; ++index) {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+        for (size_t index = 0; index < thread_count; ++index) {
+            threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, index));
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t index = 0; index < threads.size(); ++index) {
+            threads[index].join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+
+    static ThreadPool& Shared() {
+        static ThreadPool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
+
+    size_t Size() const {
+        return threads.size();
+    }
+
+    // Calls function(index) for every index in [0, count) and returns when all
+    // of them have finished; the first exception thrown is rethrown here.
+    template<class Function>
+    void ParallelFor(size_t count, const Function& function) {
+        if (count == 0) {
+            return;
+        }
+
+        std::atomic<size_t> remaining(count);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto run = [&](size_t index) {
+            try {
+                function(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            --remaining;
+        };
+
+        for (size_t index = 1; index < count; ++index) {
+            Push([&run, index] { run(index); });
+        }
+        run(0);
+
+        size_t preferred = current_pool == this ? current_queue : 0;
+        while (remaining > 0) {
+            if (!TryRunOne(preferred)) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
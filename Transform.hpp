@@ -0,0 +1,432 @@
+#pragma once
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "Arena.hpp"
+#include "ModInt.h"
+
+using std::vector;
+
+
+inline size_t TransformSize(size_t product_size) {
+    size_t size = 1;
+    while (size < product_size) {
+        size <<= 1;
+    }
+    return size;
+}
+
+inline void BitReverse(size_t size, ArenaVector<size_t>& order) {
+    order.assign(size, 0);
+    for (size_t index = 1, reversed = 0; index < size; ++index) {
+        size_t bit = size >> 1;
+        for (; reversed & bit; bit >>= 1) {
+            reversed ^= bit;
+        }
+        reversed ^= bit;
+        order[index] = reversed;
+    }
+}
+
+inline void FourierTransform(ArenaVector<std::complex<double> >& values, bool inverse) {
+    size_t size = values.size();
+    ArenaVector<size_t> order;
+    BitReverse(size, order);
+    for (size_t index = 0; index < size; ++index) {
+        if (index < order[index]) {
+            std::swap(values[index], values[order[index]]);
+        }
+    }
+
+    const double pi = std::acos(-1.0);
+    ArenaVector<std::complex<double> > roots(size / 2 + 1);
+    for (size_t index = 0; index < roots.size(); ++index) {
+        double angle = 2 * pi * index / size * (inverse ? -1 : 1);
+        roots[index] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+
+    for (size_t length = 2; length <= size; length <<= 1) {
+        size_t step = size / length;
+        for (size_t start = 0; start < size; start += length) {
+            for (size_t index = 0; index < length / 2; ++index) {
+                std::complex<double> odd = values[start + index + length / 2] * roots[index * step];
+                values[start + index + length / 2] = values[start + index] - odd;
+                values[start + index] += odd;
+            }
+        }
+    }
+
+    if (inverse) {
+        for (size_t index = 0; index < size; ++index) {
+            values[index] /= static_cast<double>(size);
+        }
+    }
+}
+
+// Worst-case absolute error of a single coefficient of FftMultiply when every
+// input coefficient is bounded by max_lhs and max_rhs: the exact product is
+// bounded by min_size * max_lhs * max_rhs, and each of the three transforms
+// contributes a relative error of at most about 3 * log2(N) * epsilon.
+inline double FftErrorBound(double max_lhs, double max_rhs, size_t min_size, size_t transform_size) {
+    double levels = std::log2(static_cast<double>(transform_size)) + 1;
+    return 9 * levels * std::numeric_limits<double>::epsilon()
+        * max_lhs * max_rhs * static_cast<double>(min_size);
+}
+
+template<class T>
+void FftMultiply(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out) {
+    size_t product_size = lhs_size + rhs_size - 1;
+    size_t size = TransformSize(product_size);
+
+    ArenaVector<std::complex<double> > packed(size);
+    for (size_t index = 0; index < lhs_size; ++index) {
+        packed[index].real(static_cast<double>(lhs[index]));
+    }
+    for (size_t index = 0; index < rhs_size; ++index) {
+        packed[index].imag(static_cast<double>(rhs[index]));
+    }
+    FourierTransform(packed, false);
+
+    ArenaVector<std::complex<double> > product(size);
+    for (size_t index = 0; index < size; ++index) {
+        std::complex<double> value = packed[index];
+        std::complex<double> mirror = std::conj(packed[(size - index) & (size - 1)]);
+        product[index] = (value * value - mirror * mirror) * std::complex<double>(0, -0.25);
+    }
+    FourierTransform(product, true);
+
+    for (size_t index = 0; index < product_size; ++index) {
+        out[index] = static_cast<T>(product[index].real());
+    }
+}
+
+struct NttPrime {
+    unsigned modulus;
+    unsigned generator;
+    unsigned max_log_size;
+};
+
+static const NttPrime kNttPrimes[] = {
+    {469762049, 3, 26},
+    {167772161, 3, 25},
+    {754974721, 11, 24},
+    {998244353, 3, 23},
+    {1004535809, 3, 21},
+};
+
+static const size_t kNttPrimesCount = sizeof(kNttPrimes) / sizeof(kNttPrimes[0]);
+
+inline unsigned long long PowerMod(unsigned long long base, unsigned long long exponent, unsigned long long modulus) {
+    unsigned long long result = 1;
+    base %= modulus;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = result * base % modulus;
+        }
+        base = base * base % modulus;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// Inverse modulo a prime by the extended Euclidean algorithm, several times
+// faster than the power modulus - 2 for word-sized moduli.
+inline unsigned long long ModularInverse(unsigned long long value, unsigned long long modulus) {
+    long long previous = 0;
+    long long current = 1;
+    unsigned long long rest = modulus;
+    value %= modulus;
+    while (value != 0) {
+        unsigned long long quotient = rest / value;
+        long long next = previous - static_cast<long long>(quotient) * current;
+        previous = current;
+        current = next;
+        unsigned long long remainder = rest % value;
+        rest = value;
+        value = remainder;
+    }
+    return previous < 0 ? static_cast<unsigned long long>(previous + static_cast<long long>(modulus))
+                        : static_cast<unsigned long long>(previous);
+}
+
+inline void NumberTheoreticTransform(ArenaVector<unsigned>& values, const NttPrime& prime, bool inverse) {
+    size_t size = values.size();
+    unsigned long long modulus = prime.modulus;
+    ArenaVector<size_t> order;
+    BitReverse(size, order);
+    for (size_t index = 0; index < size; ++index) {
+        if (index < order[index]) {
+            std::swap(values[index], values[order[index]]);
+        }
+    }
+
+    ArenaVector<unsigned> roots(size / 2 + 1);
+    for (size_t length = 2; length <= size; length <<= 1) {
+        unsigned long long root = PowerMod(prime.generator, (modulus - 1) / length, modulus);
+        if (inverse) {
+            root = PowerMod(root, modulus - 2, modulus);
+        }
+        roots[0] = 1;
+        for (size_t index = 1; index < length / 2; ++index) {
+            roots[index] = static_cast<unsigned>(roots[index - 1] * root % modulus);
+        }
+        for (size_t start = 0; start < size; start += length) {
+            for (size_t index = 0; index < length / 2; ++index) {
+                unsigned even = values[start + index];
+                unsigned odd = static_cast<unsigned>(values[start + index + length / 2] * 1ULL * roots[index] % modulus);
+                values[start + index] = even + odd >= modulus ? even + odd - modulus : even + odd;
+                values[start + index + length / 2] = even >= odd ? even - odd : even + modulus - odd;
+            }
+        }
+    }
+
+    if (inverse) {
+        unsigned long long size_inverse = PowerMod(size, modulus - 2, modulus);
+        for (size_t index = 0; index < size; ++index) {
+            values[index] = static_cast<unsigned>(values[index] * size_inverse % modulus);
+        }
+    }
+}
+
+template<class T>
+unsigned long long Magnitude(const T& value) {
+    if constexpr (std::is_signed<T>::value) {
+        return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+    } else {
+        return static_cast<unsigned long long>(value);
+    }
+}
+
+template<class T>
+unsigned ReduceModulo(const T& value, unsigned modulus) {
+    unsigned residue = static_cast<unsigned>(Magnitude(value) % modulus);
+    if constexpr (std::is_signed<T>::value) {
+        if (value < 0 && residue != 0) {
+            residue = modulus - residue;
+        }
+    }
+    return residue;
+}
+
+inline size_t BitLength(unsigned long long value) {
+    size_t length = 0;
+    while (value > 0) {
+        ++length;
+        value >>= 1;
+    }
+    return length;
+}
+
+template<class T>
+size_t NttPrimesNeeded(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size) {
+    unsigned long long max_lhs = 0;
+    unsigned long long max_rhs = 0;
+    for (size_t index = 0; index < lhs_size; ++index) {
+        max_lhs = std::max(max_lhs, Magnitude(lhs[index]));
+    }
+    for (size_t index = 0; index < rhs_size; ++index) {
+        max_rhs = std::max(max_rhs, Magnitude(rhs[index]));
+    }
+
+    double required = BitLength(max_lhs) + BitLength(max_rhs)
+        + BitLength(std::min(lhs_size, rhs_size)) + 2;
+    double available = 0;
+    for (size_t count = 0; count < kNttPrimesCount; ++count) {
+        available += std::log2(static_cast<double>(kNttPrimes[count].modulus));
+        if (available >= required) {
+            return count + 1;
+        }
+    }
+    return 0;
+}
+
+// Chinese remaindering in Garner's mixed radix form: the residues r_i modulo
+// m_i become digits d_i with x = d_0 + m_0 (d_1 + m_1 (d_2 + ...)), which
+// needs inverses of the moduli only and one small multiply-add per digit.
+struct GarnerBasis {
+    ArenaVector<unsigned long long> moduli;
+    ArenaVector<ArenaVector<unsigned long long> > inverses;
+
+    explicit GarnerBasis(const ArenaVector<unsigned long long>& moduli) : moduli(moduli), inverses(moduli.size()) {
+        for (size_t count = 0; count < moduli.size(); ++count) {
+            for (size_t other = 0; other < count; ++other) {
+                inverses[count].push_back(ModularInverse(moduli[other], moduli[count]));
+            }
+        }
+    }
+
+    // Digits of the integer with residues[count][index] modulo moduli[count].
+    template<class Residues>
+    void Digits(const Residues& residues, size_t index, unsigned long long* digits) const {
+        for (size_t count = 0; count < moduli.size(); ++count) {
+            unsigned long long modulus = moduli[count];
+            unsigned long long digit = residues[count][index];
+            for (size_t other = 0; other < count; ++other) {
+                digit = (digit + modulus - digits[other] % modulus) * inverses[count][other] % modulus;
+            }
+            digits[count] = digit;
+        }
+    }
+};
+
+template<class T>
+bool NttMultiply(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size, T* out) {
+    size_t product_size = lhs_size + rhs_size - 1;
+    size_t size = TransformSize(product_size);
+    size_t primes = NttPrimesNeeded(lhs, lhs_size, rhs, rhs_size);
+    if (primes == 0 || size > (size_t(1) << kNttPrimes[primes - 1].max_log_size)) {
+        return false;
+    }
+
+    ArenaVector<ArenaVector<unsigned> > residues(primes);
+    for (size_t count = 0; count < primes; ++count) {
+        const NttPrime& prime = kNttPrimes[count];
+        ArenaVector<unsigned> lhs_values(size);
+        ArenaVector<unsigned>& rhs_values = residues[count];
+        rhs_values.assign(size, 0);
+        for (size_t index = 0; index < lhs_size; ++index) {
+            lhs_values[index] = ReduceModulo(lhs[index], prime.modulus);
+        }
+        for (size_t index = 0; index < rhs_size; ++index) {
+            rhs_values[index] = ReduceModulo(rhs[index], prime.modulus);
+        }
+        NumberTheoreticTransform(lhs_values, prime, false);
+        NumberTheoreticTransform(rhs_values, prime, false);
+        for (size_t index = 0; index < size; ++index) {
+            rhs_values[index] = static_cast<unsigned>(lhs_values[index] * 1ULL * rhs_values[index] % prime.modulus);
+        }
+        NumberTheoreticTransform(rhs_values, prime, true);
+    }
+
+    ArenaVector<unsigned long long> moduli(primes);
+    unsigned long long modulus_product = 1;
+    double modulus_product_approx = 1;
+    for (size_t count = 0; count < primes; ++count) {
+        moduli[count] = kNttPrimes[count].modulus;
+        modulus_product *= kNttPrimes[count].modulus;
+        modulus_product_approx *= kNttPrimes[count].modulus;
+    }
+    GarnerBasis basis(moduli);
+
+    unsigned long long digits[kNttPrimesCount];
+    for (size_t index = 0; index < product_size; ++index) {
+        basis.Digits(residues, index, digits);
+        unsigned long long value = 0;
+        unsigned long long radix = 1;
+        double approx = 0;
+        double radix_approx = 1;
+        for (size_t count = 0; count < primes; ++count) {
+            value += digits[count] * radix;
+            approx += digits[count] * radix_approx;
+            radix *= moduli[count];
+            radix_approx *= moduli[count];
+        }
+        if (std::is_signed<T>::value && approx > modulus_product_approx / 2) {
+            value -= modulus_product;
+        }
+        out[index] = static_cast<T>(value);
+    }
+    return true;
+}
+
+// Smallest generator of the multiplicative group modulo a prime, found by
+// checking it against every prime factor of modulus - 1.
+inline unsigned long long PrimitiveRoot(unsigned long long modulus) {
+    ArenaVector<unsigned long long> factors;
+    unsigned long long rest = modulus - 1;
+    for (unsigned long long factor = 2; factor * factor <= rest; ++factor) {
+        if (rest % factor == 0) {
+            factors.push_back(factor);
+            while (rest % factor == 0) {
+                rest /= factor;
+            }
+        }
+    }
+    if (rest > 1) {
+        factors.push_back(rest);
+    }
+
+    for (unsigned long long generator = 2;; ++generator) {
+        bool primitive = true;
+        for (size_t index = 0; index < factors.size() && primitive; ++index) {
+            primitive = PowerMod(generator, (modulus - 1) / factors[index], modulus) != 1;
+        }
+        if (primitive) {
+            return generator;
+        }
+    }
+}
+
+// Transform directly over the coefficient field, with the butterflies done in
+// Montgomery arithmetic; size must divide Modulus - 1.
+template<unsigned Modulus>
+void ModularTransform(ArenaVector<ModInt<Modulus> >& values, bool inverse) {
+    typedef ModInt<Modulus> Mod;
+    static const Mod generator(static_cast<long long>(PrimitiveRoot(Modulus)));
+
+    size_t size = values.size();
+    ArenaVector<size_t> order;
+    BitReverse(size, order);
+    for (size_t index = 0; index < size; ++index) {
+        if (index < order[index]) {
+            std::swap(values[index], values[order[index]]);
+        }
+    }
+
+    ArenaVector<Mod> roots(size / 2 + 1);
+    for (size_t length = 2; length <= size; length <<= 1) {
+        Mod root = generator.Power((Modulus - 1) / length);
+        if (inverse) {
+            root = root.Inverse();
+        }
+        roots[0] = Mod(1);
+        for (size_t index = 1; index < length / 2; ++index) {
+            roots[index] = roots[index - 1] * root;
+        }
+        for (size_t start = 0; start < size; start += length) {
+            for (size_t index = 0; index < length / 2; ++index) {
+                Mod even = values[start + index];
+                Mod odd = values[start + index + length / 2] * roots[index];
+                values[start + index] = even + odd;
+                values[start + index + length / 2] = even - odd;
+            }
+        }
+    }
+
+    if (inverse) {
+        Mod size_inverse = Mod(static_cast<long long>(size)).Inverse();
+        for (size_t index = 0; index < size; ++index) {
+            values[index] *= size_inverse;
+        }
+    }
+}
+
+// Returns false when the transform size does not divide Modulus - 1, in which
+// case the caller falls back to Karatsuba/Toom-3.
+template<unsigned Modulus>
+bool ModularNttMultiply(const ModInt<Modulus>* lhs, size_t lhs_size, const ModInt<Modulus>* rhs, size_t rhs_size,
+                        ModInt<Modulus>* out) {
+    size_t product_size = lhs_size + rhs_size - 1;
+    size_t size = TransformSize(product_size);
+    if ((Modulus - 1) % size != 0) {
+        return false;
+    }
+
+    ArenaVector<ModInt<Modulus> > lhs_values(lhs, lhs + lhs_size);
+    ArenaVector<ModInt<Modulus> > rhs_values(rhs, rhs + rhs_size);
+    lhs_values.resize(size);
+    rhs_values.resize(size);
+    ModularTransform(lhs_values, false);
+    ModularTransform(rhs_values, false);
+    for (size_t index = 0; index < size; ++index) {
+        rhs_values[index] *= lhs_values[index];
+    }
+    ModularTransform(rhs_values, true);
+    std::copy(rhs_values.begin(), rhs_values.begin() + product_size, out);
+    return true;
+}